@@ -1504,7 +1504,9 @@ namespace das
         bool        export_all = false;                 // when user compiles, export all (public?) functions
         bool        serialize_main_module = true;       // if false, then we recompile main module each time
         bool        keep_alive = false;                 // produce keep-alive noodes
-        /*option*/ bool        very_safe_context = false;          // context is very safe (does not release old memory from array or table grow, leaves it to GC)
+        /*option*/ bool        very_safe_context = false;          // context is very safe (does not release old memory from array or table grow, retires it until heap_collect_retired or GC)
+        /*option*/ bool        incremental_table_resize = false;   // table grow keeps the previous storage and moves entries from it a few at a time, on each insert or erase
+        /*option*/ bool        parallel_gc_mark = false;           // heap_collect marks on job que threads, when called inside 'with_job_que'
     // error reporting
         int32_t     always_report_candidates_threshold = 6; // always report candidates if there are less than this number
     // infer passes
@@ -1515,6 +1517,7 @@ namespace das
         /*option*/ uint32_t    stack = 16*1024;                    // 0 for unique stack
         /*option*/ bool        intern_strings = false;             // use string interning lookup for regular string heap
         /*option*/ bool        persistent_heap = false;
+        /*option*/ bool        size_class_heap = false;            // persistent heap allocates from size class runs (see SizeClassHeapAllocator)
         /*option*/ bool        multiple_contexts = false;          // code supports context safety
         /*option*/ uint32_t    heap_size_hint = 65536;
         /*option*/ uint32_t    string_heap_size_hint = 65536;
@@ -1569,6 +1572,7 @@ namespace das
         /*option*/ bool log_compile_time = false;                  // if true, then compile time will be printed at the end of the compilation
         /*option*/ bool log_total_compile_time = false;            // if true, then detailed compile time will be printed at the end of the compilation
         /*option*/ bool no_fast_call = false;                      // disable fastcall
+        /*option*/ bool bytecode = false;                          // run int, float, and bool only functions on the register bytecode
         /*option*/ bool scoped_stack_allocator = true;             // reuse stack memory after variables out of scope
         /*option*/ bool force_inscope_pod = false;                 // force in-scope for POD-like types
         /*option*/ bool log_inscope_pod = false;                   // log in-scope for POD-like types
@@ -1699,6 +1703,8 @@ namespace das
         void updateSemanticHash();
         void updateKeepAliveFlags();
         bool simulate ( Context & context, TextWriter & logs, StackAllocator * sharedStack = nullptr );
+        void lowerToBytecode ( Context & context, TextWriter & logs );
+        void applyPgoProfile ( TextWriter & logs );
         uint64_t getInitSemanticHashWithDep( uint64_t initHash );
         void error ( const string & str, const string & extra, const string & fixme, const LineInfo & at, CompilationError cerr = CompilationError::unspecified );
         void deduplicateErrors ();
@@ -1809,6 +1815,11 @@ namespace das
     DAS_API ProgramPtr compileDaScriptSerialize ( const string & fileName, const FileAccessPtr & access,
         TextWriter & logs, ModuleGroup & libGroup, CodeOfPolicies policies = CodeOfPolicies() );
 
+    // same as compileDaScript, but goes through the program cache file first
+    // cached program is reused when policies, and content of every source file and builtin module it was built from, did not change
+    DAS_API ProgramPtr compileDaScriptCached ( const string & fileName, const string & cacheFileName, const FileAccessPtr & access,
+        TextWriter & logs, ModuleGroup & libGroup, CodeOfPolicies policies = CodeOfPolicies(), bool * cacheHit = nullptr );
+
     // collect script prerequisits
     DAS_API bool getPrerequisits ( const string & fileName,
                           const FileAccessPtr & access,
@@ -1337,6 +1337,8 @@ namespace das
             struct {
                 bool isStatic : 1;
                 bool doNotFold : 1;
+                bool isLikely : 1;      // profile says if_true runs almost always
+                bool isUnlikely : 1;    // profile says if_true almost never runs
             };
             uint32_t ifFlags = 0;
         };
@@ -99,6 +99,12 @@ using das_safe_set = std::set<K,C>;
   #define DAS_DEBUGGER  1
 #endif
 
+// if enabled, builtin tables probe the hash array 8 slots at a time with SIMD compares
+// table layout and probe order are the same either way
+#ifndef DAS_TABLE_GROUP_PROBE
+  #define DAS_TABLE_GROUP_PROBE 1
+#endif
+
 #ifndef DAS_BIND_EXTERNAL
   #if defined(_WIN32) && defined(_WIN64)
     #define DAS_BIND_EXTERNAL 1
@@ -200,10 +200,14 @@ namespace das {
         char *keys;
         TableHashKey *hashes;
         uint32_t tombstones;
+        uint32_t resizeIndex;       // next slot of the previous storage to move (incremental resize)
+        char *resizeData;           // previous storage, while incremental resize is in progress
+        uint32_t resizeCapacity;    // capacity of the previous storage
     };
 
     DAS_API void table_clear(Context &context, Table &arr, LineInfo *at);
     DAS_API void table_lock(Context &context, Table &arr, LineInfo *at);
+    DAS_API void table_finish_resize(Context *context, Table &tab, LineInfo *at);   // moves what is left of incremental resize
     DAS_API void table_unlock(Context &context, Table &arr, LineInfo *at);
     DAS_API void table_reserve_impl(Context &context, Table &arr, int32_t baseType, uint32_t newCapacity, uint32_t valueTypeSize, LineInfo *at);
 
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <daScript/misc/platform.h>
+#include <vecmath/dag_vecMath.h>
+
+// Byte-class scanners for text readers and writers (json_scan, json_print, escapeString).
+// Each scanner returns the first byte in [cur,end) which belongs to its class.
+// Full 16-byte blocks are classified with SSE2 or NEON compares, the tail is scanned one byte at a time.
+
+namespace das {
+
+#if _TARGET_SIMD_SSE
+
+    typedef __m128i byte_block;
+
+    __forceinline byte_block byte_block_load ( const char * p ) { return _mm_loadu_si128((const __m128i *)p); }
+    __forceinline byte_block byte_block_eq ( byte_block a, char ch ) { return _mm_cmpeq_epi8(a, _mm_set1_epi8(ch)); }
+    __forceinline byte_block byte_block_or ( byte_block a, byte_block b ) { return _mm_or_si128(a, b); }
+    // unsigned a < ch
+    __forceinline byte_block byte_block_lt ( byte_block a, uint8_t ch ) {
+        auto lim = _mm_set1_epi8(char(ch - 1));
+        return _mm_cmpeq_epi8(_mm_max_epu8(a, lim), lim);
+    }
+    // index of the first set lane, 16 if none
+    __forceinline uint32_t byte_block_first ( byte_block m ) {
+        uint32_t bits = uint32_t(_mm_movemask_epi8(m));
+        return bits ? das_ctz(bits) : 16u;
+    }
+
+#elif _TARGET_SIMD_NEON
+
+    typedef uint8x16_t byte_block;
+
+    __forceinline byte_block byte_block_load ( const char * p ) { return vld1q_u8((const uint8_t *)p); }
+    __forceinline byte_block byte_block_eq ( byte_block a, char ch ) { return vceqq_u8(a, vdupq_n_u8(uint8_t(ch))); }
+    __forceinline byte_block byte_block_or ( byte_block a, byte_block b ) { return vorrq_u8(a, b); }
+    __forceinline byte_block byte_block_lt ( byte_block a, uint8_t ch ) { return vcltq_u8(a, vdupq_n_u8(ch)); }
+    // narrowing shift packs the 16 lanes into 4 bits each
+    __forceinline uint32_t byte_block_first ( byte_block m ) {
+        uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        return bits ? uint32_t(das_ctz64(bits) >> 2) : 16u;
+    }
+
+#endif
+
+    __forceinline bool is_json_ws ( char ch ) {
+        return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r';
+    }
+
+    // first '"' or '\\'
+    __forceinline const char * scan_quote_or_backslash ( const char * cur, const char * end ) {
+#if _TARGET_SIMD_SSE || _TARGET_SIMD_NEON
+        while ( end - cur >= 16 ) {
+            auto b = byte_block_load(cur);
+            uint32_t i = byte_block_first(byte_block_or(byte_block_eq(b,'"'), byte_block_eq(b,'\\')));
+            if ( i!=16 ) return cur + i;
+            cur += 16;
+        }
+#endif
+        while ( cur < end && *cur!='"' && *cur!='\\' ) cur++;
+        return cur;
+    }
+
+    // first byte which is not JSON whitespace
+    __forceinline const char * skip_json_ws ( const char * cur, const char * end ) {
+        // most tokens are not preceded by whitespace, or by a single space
+        if ( cur < end && !is_json_ws(*cur) ) return cur;
+        if ( cur < end ) cur++;
+#if _TARGET_SIMD_SSE || _TARGET_SIMD_NEON
+        while ( end - cur >= 16 ) {
+            auto b = byte_block_load(cur);
+            auto ws = byte_block_or(byte_block_or(byte_block_eq(b,' '), byte_block_eq(b,'\t')),
+                byte_block_or(byte_block_eq(b,'\n'), byte_block_eq(b,'\r')));
+            // first lane which is not whitespace
+            uint32_t i = byte_block_first(byte_block_eq(ws, 0));
+            if ( i!=16 ) return cur + i;
+            cur += 16;
+        }
+#endif
+        while ( cur < end && is_json_ws(*cur) ) cur++;
+        return cur;
+    }
+
+    // first byte which escapeString has to rewrite: '"', '\\', control characters, and '{' '}' for das strings
+    __forceinline const char * scan_escape ( const char * cur, const char * end, bool das_escape ) {
+#if _TARGET_SIMD_SSE || _TARGET_SIMD_NEON
+        while ( end - cur >= 16 ) {
+            auto b = byte_block_load(cur);
+            auto m = byte_block_or(byte_block_or(byte_block_eq(b,'"'), byte_block_eq(b,'\\')), byte_block_lt(b,0x20));
+            if ( das_escape ) m = byte_block_or(m, byte_block_or(byte_block_eq(b,'{'), byte_block_eq(b,'}')));
+            uint32_t i = byte_block_first(m);
+            if ( i!=16 ) return cur + i;
+            cur += 16;
+        }
+#endif
+        for ( ; cur < end; ++cur ) {
+            auto ch = uint8_t(*cur);
+            if ( ch=='"' || ch=='\\' || ch<0x20 || (das_escape && (ch=='{' || ch=='}')) ) break;
+        }
+        return cur;
+    }
+}
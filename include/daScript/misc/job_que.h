@@ -11,6 +11,7 @@ namespace das {
     // shared tracking counter for JobStatus and Feature
     DAS_API extern atomic<uint64_t> g_jobque_track_total;
     DAS_API extern atomic<uint64_t> g_jobque_track_id;       // ID to detail-trace (0 = none)
+    DAS_API extern atomic<int32_t>  g_jobque_backend;        // JobQueBackend of job ques, created from now on
     // single job
     typedef function<void()> Job;
     typedef function<void(int,int)> JobChunk;
@@ -75,9 +76,39 @@ namespace das {
         uint32_t            mMagic = uint32_t(STATUS_MAGIC);
     };
 
+    enum class JobQueBackend : int32_t {
+        Fifo = 0,               // one priority ordered fifo, shared by all workers
+        WorkStealing = 1,       // per worker deques, idle workers steal. jobs with category or priority still go to the fifo
+    };
+
+    // Chase-Lev work stealing deque ("Correct and Efficient Work-Stealing for Weak Memory Models", Le et al.)
+    // owner pushes and takes at the bottom, other threads steal from the top
+    class JobDeque {
+    public:
+        JobDeque();
+        JobDeque ( const JobDeque & ) = delete;
+        JobDeque & operator = ( const JobDeque & ) = delete;
+        void push ( Job * job );
+        Job * take();
+        Job * steal();
+    protected:
+        struct Ring {
+            Ring ( int64_t size ) : mask(size-1), slots(new atomic<Job *>[size]) {}
+            Job * get ( int64_t i ) const { return slots[i & mask].load(memory_order_relaxed); }
+            void put ( int64_t i, Job * job ) { slots[i & mask].store(job, memory_order_relaxed); }
+            int64_t                     mask;
+            unique_ptr<atomic<Job *>[]> slots;
+        };
+        atomic<int64_t>             mTop{0};
+        atomic<int64_t>             mBottom{0};
+        atomic<Ring *>              mRing{nullptr};
+        vector<unique_ptr<Ring>>    mRings;     // thieves may still read from the previous ring, so they all live as long as the deque
+    };
+
     class JobQue {
     public:
         JobQue();
+        JobQue ( JobQueBackend backend );
         JobQue ( const JobQue & ) = delete;
         JobQue ( JobQue && ) = delete;
         JobQue & operator = ( const JobQue & ) = delete;
@@ -87,6 +118,7 @@ namespace das {
         bool areJobsPending(JobCategory category);
         int getNumberOfQueuedJobs();
         int getTotalHwJobs();
+        JobQueBackend getBackend() const { return mBackend; }
         void push(Job && job, JobCategory category, JobPriority priority);
         void parallel_for ( JobStatus & status, int from, int to, const JobChunk & chunk, JobCategory category, JobPriority priority, int chunk_count = -1, int step = 1 );
         void parallel_for ( int from, int to, const JobChunk & chunk, JobCategory category, JobPriority priority, int chunk_count = -1, int step = 1 );
@@ -119,6 +151,21 @@ namespace das {
         void join();
         void job(int threadIndex);
         void submit(Job && job, JobCategory category, JobPriority priority);
+    protected:
+        struct StealWorker {
+            JobDeque        jobs;           // jobs, pushed by the worker itself
+            mutex           injectMutex;    // jobs, pushed by other threads
+            deque<Job *>    inject;
+            atomic<int>     injectSize{0};
+        };
+        __forceinline bool isStealJob ( JobCategory category, JobPriority priority ) const {
+            return mBackend==JobQueBackend::WorkStealing && category==0 && priority==JobPriority::Default;
+        }
+        void stealJob(int threadIndex);
+        void pushSteal(Job * job);
+        Job * findSteal(int threadIndex, uint32_t & seed);
+        Job * popInject(StealWorker & worker, bool tryLock);
+        bool popFifo(int threadIndex, Job & job);
     protected:
         condition_variable mCond;
         int mSleepMs;
@@ -130,6 +177,13 @@ namespace das {
         deque<JobEntry> mFifo;
         vector<ThreadEntry> mThreads;
         atomic<int> mJobsRunning{0};
+    protected:
+        JobQueBackend                   mBackend = JobQueBackend::Fifo;
+        vector<unique_ptr<StealWorker>> mStealWorkers;
+        atomic<uint32_t>                mStealNext{0};      // round robin over workers, for jobs pushed from other threads
+        atomic<int>                     mStealQueued{0};
+        atomic<int>                     mStealRunning{0};
+        atomic<int>                     mFifoSize{0};       // lets work stealing workers skip the fifo lock
     protected:
         mutex mEvalMainThreadMutex;
         vector<Job> mEvalMainThread;
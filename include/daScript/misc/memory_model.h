@@ -9,6 +9,15 @@ namespace das {
 #endif
 
     #define DAS_PAGE_GC_MASK    0x80000000
+
+    // parallel gc mark sets gc bits and counters in place
+    static_assert(sizeof(atomic<uint32_t>)==sizeof(uint32_t) && ATOMIC_INT_LOCK_FREE==2, "gc bits are marked as atomic<uint32_t>");
+    __forceinline bool das_atomic_mark_bit ( uint32_t * word, uint32_t bit ) {
+        return !( ((atomic<uint32_t> *)word)->fetch_or(bit, memory_order_relaxed) & bit );
+    }
+    __forceinline void das_atomic_increment ( uint32_t * counter ) {
+        ((atomic<uint32_t> *)counter)->fetch_add(1, memory_order_relaxed);
+    }
     #define DAS_MAX_SHOE_ALLOCATION     256
     #define DAS_MAX_SHOE_CUNKS          (DAS_MAX_SHOE_ALLOCATION>>4)
 
@@ -122,6 +131,16 @@ namespace das {
             }
             return false;
         }
+        __forceinline bool markAtomic ( char * ptr ) {
+            ptrdiff_t idx = (ptr - data) / size;
+            DAS_ASSERT ( idx>=0 && idx<ptrdiff_t(total) );
+            uint32_t uidx = uint32_t(idx);
+            if ( das_atomic_mark_bit(gc_bits + (uidx >> 5), 1u << (uidx & 31)) ) {
+                das_atomic_increment(&gc_allocated);
+                return true;
+            }
+            return false;
+        }
         char *      data = nullptr;
         uint32_t *  bits = nullptr;
         uint32_t *  gc_bits = nullptr;
@@ -196,6 +215,18 @@ namespace das {
             }
             return false;
         }
+        // no lastChunk cache, safe to call from several threads at once
+        bool markAtomic ( char * ptr, uint32_t size ) const {
+            size = (size + 15) & ~15;
+            DAS_ASSERT(size && size<=DAS_MAX_SHOE_ALLOCATION);
+            uint32_t si = (size >> 4) - 1;
+            for ( auto ch = chunks[si]; ch; ch=ch->next ) {
+                if ( ch->isOwnPtr(ptr) ) {
+                    return ch->markAtomic(ptr);
+                }
+            }
+            return false;
+        }
         void beforeGC() {
             for ( int i=0; i!=DAS_MAX_SHOE_CUNKS; ++i ) {
                 if ( chunks[i] ) chunks[i]->beforeGC();
@@ -335,6 +366,201 @@ namespace das {
 #endif
     };
 
+    #define DAS_SIZE_CLASS_PAGE_SHIFT       14
+    #define DAS_SIZE_CLASS_PAGE_SIZE        (1u<<DAS_SIZE_CLASS_PAGE_SHIFT)
+    #define DAS_MAX_SIZE_CLASS_ALLOCATION   4096
+    #define DAS_SIZE_CLASS_COUNT            40
+
+    // run of same size slots, which occupies one aligned page. free slots are kept in the intrusive list,
+    // slots past 'bump' were never allocated. bits are the same allocated and gc bits as in the Deck
+    struct SizeClassRun {
+        enum {
+            maxSlots = DAS_SIZE_CLASS_PAGE_SIZE / 16,
+            maxWords = maxSlots / 32
+        };
+        void init ( char * pageData, uint32_t si, uint32_t slotSize ) {
+            data = pageData;
+            sizeClass = si;
+            size = slotSize;
+            total = DAS_SIZE_CLASS_PAGE_SIZE / slotSize;
+            clear();
+        }
+        void clear() {
+            freeList = nullptr;
+            nextPartial = nullptr;
+            inPartial = false;
+            bump = 0;
+            allocated = 0;
+            gc_allocated = 0;
+            memset(bits, 0, sizeof(bits));
+        }
+        __forceinline uint32_t slotIndex ( char * ptr ) const {
+            return uint32_t(ptr - data) / size;
+        }
+        // pointer to the beginning of the slot, which was handed out at some point
+        __forceinline bool isSlotPtr ( char * ptr ) const {
+            uint32_t ofs = uint32_t(ptr - data);
+            return (ofs % size)==0 && (ofs / size)<bump;
+        }
+        __forceinline bool isAllocatedPtr ( char * ptr ) const {
+            uint32_t idx = slotIndex(ptr);
+            return (bits[idx>>5] & (1u<<(idx&31)))!=0;
+        }
+        __forceinline bool hasRoom() const {
+            return freeList || bump!=total;
+        }
+        __forceinline char * allocate ( ) {
+            char * res;
+            uint32_t idx;
+            if ( freeList ) {
+                res = freeList;
+                freeList = *(char **)res;
+                idx = slotIndex(res);
+            } else {
+                idx = bump ++;
+                res = data + idx * size;
+            }
+            bits[idx>>5] |= 1u<<(idx&31);
+            allocated ++;
+            return res;
+        }
+        __forceinline void free ( char * ptr ) {
+            uint32_t idx = slotIndex(ptr);
+            DAS_ASSERT((bits[idx>>5] & (1u<<(idx&31)))!=0 && "calling free on the pointer, which is already free");
+            bits[idx>>5] ^= 1u<<(idx&31);
+            *(char **)ptr = freeList;
+            freeList = ptr;
+            allocated --;
+        }
+        __forceinline bool mark ( char * ptr ) {
+            uint32_t idx = slotIndex(ptr);
+            uint32_t b = gc_bits[idx>>5];
+            if ( !(b & (1u<<(idx&31))) ) {
+                gc_bits[idx>>5] = b | (1u<<(idx&31));
+                gc_allocated ++;
+                return true;
+            }
+            return false;
+        }
+        __forceinline bool markAtomic ( char * ptr ) {
+            uint32_t idx = slotIndex(ptr);
+            if ( das_atomic_mark_bit(gc_bits + (idx>>5), 1u<<(idx&31)) ) {
+                das_atomic_increment(&gc_allocated);
+                return true;
+            }
+            return false;
+        }
+        char *          data = nullptr;
+        char *          freeList = nullptr;
+        SizeClassRun *  nextPartial = nullptr;      // next run of the same class, which has room
+        uint32_t        sizeClass = 0;
+        uint32_t        size = 0;                   // 0 if page is not used by any class
+        uint32_t        total = 0;
+        uint32_t        bump = 0;
+        uint32_t        allocated = 0;
+        uint32_t        gc_allocated = 0;
+        bool            inPartial = false;
+        uint32_t        bits[maxWords];
+        uint32_t        gc_bits[maxWords];
+    };
+
+    // size class allocator. sizes up to DAS_MAX_SIZE_CLASS_ALLOCATION are rounded up to one of DAS_SIZE_CLASS_COUNT classes,
+    // each class allocates from its own runs with O(1) pop. runs are carved out of page aligned arenas,
+    // so the run is found from the pointer with a range check per arena. arenas grow geometrically, so there are only a few.
+    // everything bigger is up to the caller
+    struct DAS_API SizeClassModel {
+        enum { default_initial_size = 65536 };
+        SizeClassModel(const SizeClassModel &) = delete;
+        SizeClassModel & operator = (const SizeClassModel &) = delete;
+        SizeClassModel ();
+        ~SizeClassModel ();
+        static __forceinline uint32_t sizeClass ( uint32_t size ) {
+            size = (size + 15) & ~15;
+            DAS_ASSERT(size && size<=DAS_MAX_SIZE_CLASS_ALLOCATION);
+            if ( size<=256 ) return (size >> 4) - 1;                // 16 byte steps
+            else if ( size<=1024 ) return 15 + ((size - 256 + 63) >> 6);   // 64 byte steps
+            else return 27 + ((size - 1024 + 255) >> 8);            // 256 byte steps
+        }
+        static __forceinline uint32_t classSize ( uint32_t si ) {
+            if ( si<16 ) return (si + 1) << 4;
+            else if ( si<28 ) return 256 + (si - 15) * 64;
+            else return 1024 + (si - 27) * 256;
+        }
+        __forceinline char * allocate ( uint32_t size ) {
+            uint32_t si = sizeClass(size);
+            auto run = partial[si];
+            if ( !run ) run = newRun(si);
+            char * res = run->allocate();
+            if ( !run->hasRoom() ) {
+                partial[si] = run->nextPartial;
+                run->nextPartial = nullptr;
+                run->inPartial = false;
+            }
+            totalAllocated += run->size;
+            return res;
+        }
+        __forceinline void free ( char * ptr, uint32_t size ) {
+            auto run = findRun(ptr);
+            DAS_VERIFYF(run && run->sizeClass==sizeClass(size), "deleting %p %i, which is not a size class pointer (or size mismatch)", (void *)ptr, int(size));
+#if DAS_SANITIZER
+            memset(ptr, 0xcd, run->size);
+#endif
+            run->free(ptr);
+            totalAllocated -= run->size;
+            if ( !run->inPartial ) {
+                run->nextPartial = partial[run->sizeClass];
+                run->inPartial = true;
+                partial[run->sizeClass] = run;
+            }
+        }
+        __forceinline SizeClassRun * findRun ( char * ptr ) const {
+            for ( auto ita = arenas.rbegin(); ita!=arenas.rend(); ++ita ) {  // latest arena is the biggest one
+                uintptr_t ofs = uintptr_t(ptr) - uintptr_t(ita->base);
+                if ( ofs < (uintptr_t(ita->count) << DAS_SIZE_CLASS_PAGE_SHIFT) ) {
+                    return ita->runs + (ofs >> DAS_SIZE_CLASS_PAGE_SHIFT);
+                }
+            }
+            return nullptr;
+        }
+        __forceinline bool isOwnPtr ( char * ptr ) const {
+            auto run = findRun(ptr);
+            return run && run->size && run->isSlotPtr(ptr);
+        }
+        __forceinline bool isAllocatedPtr ( char * ptr ) const {
+            auto run = findRun(ptr);
+            return run && run->size && run->isSlotPtr(ptr) && run->isAllocatedPtr(ptr);
+        }
+        __forceinline bool mark ( char * ptr ) {
+            auto run = findRun(ptr);
+            return run && run->size && run->isSlotPtr(ptr) && run->mark(ptr);
+        }
+        __forceinline bool markAtomic ( char * ptr ) {
+            auto run = findRun(ptr);
+            return run && run->size && run->isSlotPtr(ptr) && run->markAtomic(ptr);
+        }
+        void beforeGC();
+        void sweep();
+        void reset();
+        void shrink();
+        uint32_t depth() const;
+        uint64_t bytesAllocated() const { return totalAllocated; }
+        uint64_t totalAlignedMemoryAllocated() const;
+        SizeClassRun * newRun ( uint32_t si );
+        void newArena();
+        struct Arena {
+            void *          memory;     // as allocated
+            char *          base;       // first page aligned run
+            SizeClassRun *  runs;
+            uint32_t        count;
+        };
+        CustomGrowFunction                      customGrow;
+        uint32_t                                initialSize = 0;
+        uint64_t                                totalAllocated = 0;
+        SizeClassRun *                          partial[DAS_SIZE_CLASS_COUNT];
+        vector<SizeClassRun *>                  freeRuns;   // pages, which are not used by any class
+        vector<Arena>                           arenas;
+    };
+
     struct HeapChunk {
         __forceinline HeapChunk ( uint32_t s, HeapChunk * n ) {
             s = (s + 15) & ~15;
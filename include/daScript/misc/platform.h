@@ -144,6 +144,15 @@
     #define DAS_FORMAT_STRING_PREFIX
 #endif
 
+// branch hints, AOT emits them for profiled branches
+#if defined(__GNUC__) || defined(__clang__)
+    #define DAS_LIKELY(x)                       __builtin_expect(!!(x),1)
+    #define DAS_UNLIKELY(x)                     __builtin_expect(!!(x),0)
+#else
+    #define DAS_LIKELY(x)                       (x)
+    #define DAS_UNLIKELY(x)                     (x)
+#endif
+
 #if defined(_MSC_VER)
     __forceinline uint32_t das_clz(uint32_t x) {
         unsigned long r = 0;
@@ -1026,6 +1026,10 @@ namespace das {
             flags = arr.flags; arr.flags = 0;
             keys = arr.keys; arr.keys = 0;
             hashes = arr.hashes; arr.hashes = 0;
+            tombstones = arr.tombstones; arr.tombstones = 0;
+            resizeIndex = arr.resizeIndex; arr.resizeIndex = 0;
+            resizeData = arr.resizeData; arr.resizeData = 0;
+            resizeCapacity = arr.resizeCapacity; arr.resizeCapacity = 0;
         }
         __forceinline TV & operator () ( const TK & key, Context * __context__ ) {
             TableHash<TK> thh(__context__,sizeof(TV));
@@ -1067,6 +1071,10 @@ namespace das {
             flags = arr.flags; arr.flags = 0;
             keys = arr.keys; arr.keys = 0;
             hashes = arr.hashes; arr.hashes = 0;
+            tombstones = arr.tombstones; arr.tombstones = 0;
+            resizeIndex = arr.resizeIndex; arr.resizeIndex = 0;
+            resizeData = arr.resizeData; arr.resizeData = 0;
+            resizeCapacity = arr.resizeCapacity; arr.resizeCapacity = 0;
         }
     };
 
@@ -1755,6 +1763,7 @@ namespace das {
         static __forceinline void clear ( Context * __context__, TTable<TKey,TVal> & tab ) {
             if ( tab.data ) {
                 if ( !tab.isLocked() ) {
+                    if ( tab.resizeData ) table_finish_resize(__context__, tab, nullptr);
                     uint32_t oldSize = tab.capacity*(sizeof(TKey)+sizeof(TVal)+sizeof(TableHashKey));
                     __context__->free(tab.data, oldSize);
                 } else {
@@ -2053,6 +2062,7 @@ namespace das {
             pp->info = nullptr;
             pp->fileName = fn;
             pp->stackSize = stackSize;
+            DAS_PROFILE_SAMPLE(*context);
 #endif
         }
         __forceinline ~das_stack_prologue () {
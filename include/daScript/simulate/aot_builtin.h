@@ -56,6 +56,9 @@ namespace das {
     DAS_API void string_heap_report ( Context * context, LineInfoArg * info );
     DAS_API bool is_intern_strings ( Context * context );
     DAS_API void heap_collect ( bool stringHeap, bool validate, Context * context, LineInfoArg * info );
+    DAS_API uint4 heap_collect_stats ( Context * context );
+    DAS_API uint64_t heap_collect_retired ( Context * context, LineInfoArg * info );
+    DAS_API uint64_t heap_retired_bytes ( Context * context );
     DAS_API void heap_report ( Context * context, LineInfoArg * info );
     DAS_API void memory_report ( bool errorsOnly, Context * context, LineInfoArg * info );
     DAS_API uint64_t gc_thread_root_count();
@@ -123,6 +126,46 @@ namespace das {
     DAS_API void builtin_sort_string ( void * data, int32_t length );
     DAS_API void builtin_sort_any_cblock ( void * anyData, int32_t elementSize, int32_t length, const Block & cmp, Context * context, LineInfoArg * lineinfo );
     DAS_API void builtin_sort_any_ref_cblock ( void * anyData, int32_t elementSize, int32_t length, const Block & cmp, Context * context, LineInfoArg * lineinfo );
+    DAS_API void builtin_sort_stable_array_any_cblock ( Array & arr, int32_t elementSize, int32_t length, const Block & cmp, Context * context, LineInfoArg * lineinfo );
+    DAS_API void builtin_sort_stable_array_any_ref_cblock ( Array & arr, int32_t elementSize, int32_t length, const Block & cmp, Context * context, LineInfoArg * lineinfo );
+
+    // parallel (inside with_job_que), radix, and by key sorts of numbers
+    enum class SortKey : int32_t { Int, UInt, Int64, UInt64, Float, Double };
+    template <typename TT> struct sort_key_type;
+    template <> struct sort_key_type<int32_t>   { static constexpr SortKey value = SortKey::Int; };
+    template <> struct sort_key_type<uint32_t>  { static constexpr SortKey value = SortKey::UInt; };
+    template <> struct sort_key_type<int64_t>   { static constexpr SortKey value = SortKey::Int64; };
+    template <> struct sort_key_type<uint64_t>  { static constexpr SortKey value = SortKey::UInt64; };
+    template <> struct sort_key_type<float>     { static constexpr SortKey value = SortKey::Float; };
+    template <> struct sort_key_type<double>    { static constexpr SortKey value = SortKey::Double; };
+
+    DAS_API void builtin_sort_parallel_any ( void * data, int32_t length, SortKey key );
+    DAS_API void builtin_sort_string_parallel ( void * data, int32_t length );
+    DAS_API void builtin_sort_radix_any ( void * data, int32_t length, SortKey key );
+    DAS_API void builtin_sort_by_key_any ( Array & arr, int32_t elementSize, const void * keys, int32_t numKeys, SortKey key, bool descending, Context * context, LineInfoArg * at );
+
+    template <typename TT>
+    __forceinline void builtin_sort_parallel ( TT * data, int32_t length ) {
+        builtin_sort_parallel_any(data, length, sort_key_type<TT>::value);
+    }
+
+    template <typename TT>
+    __forceinline void builtin_sort_radix ( TT * data, int32_t length ) {
+        builtin_sort_radix_any(data, length, sort_key_type<TT>::value);
+    }
+
+    template <typename TT>
+    struct TArray;
+
+    template <typename TT>
+    struct TTemporary;
+
+    DAS_API bool builtin_json_stream ( const TBlock<int32_t,TTemporary<TArray<uint8_t>>> & reader, const TBlock<void,TTemporary<const char *>> & blk, Context * context, LineInfoArg * at );
+
+    template <typename KT>
+    __forceinline void builtin_sort_by_key ( Array & arr, int32_t elementSize, const TArray<KT> & keys, bool descending, Context * context, LineInfoArg * at ) {
+        builtin_sort_by_key_any(arr, elementSize, keys.data, int32_t(keys.size), sort_key_type<KT>::value, descending, context, at);
+    }
 
     __forceinline int32_t variant_index(const Variant & v) { return v.index; }
     __forceinline void set_variant_index(Variant & v, int32_t index) { v.index = index; }
@@ -32,6 +32,10 @@ namespace das {
     DAS_API void instrument_all_functions_ex ( Context & ctx, const TBlock<uint64_t,Func,const SimFunction *> & blk, Context * context, LineInfoArg * arg );
     DAS_API void instrument_all_functions_thread_local_ex ( Context & ctx, const TBlock<uint64_t,Func,const SimFunction *> & blk, Context * context, LineInfoArg * arg );
     DAS_API void clear_instruments ( Context & ctx );
+    DAS_API void sampling_profiler_start ( Context & ctx, int32_t intervalUsec );
+    DAS_API void sampling_profiler_stop ( Context & ctx );
+    DAS_API uint64_t sampling_profiler_samples ( Context & ctx );
+    DAS_API char * sampling_profiler_report ( Context & ctx, Context * context, LineInfoArg * at );
 
     DAS_API bool has_function ( Context & ctx, const char * name );
 
@@ -60,6 +60,14 @@ namespace das {
     DAS_API vec4f builtin_write ( Context &, SimNode_CallBase * call, vec4f * args );
     DAS_API vec4f builtin_load ( Context & context, SimNode_CallBase *, vec4f * args );
     DAS_API void builtin_map_file ( const FILE* _f, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context*, LineInfoArg * at );
+    // windowed mapping, for files of any size. window itself is an array, so it has to be under 4GB
+    enum FMapAdvice : int32_t { fmap_normal, fmap_sequential, fmap_random, fmap_willneed, fmap_dontneed };
+    DAS_API void builtin_map_file_range ( const FILE* _f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context*, LineInfoArg * at );
+    DAS_API void builtin_map_file_shared ( const FILE* _f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context*, LineInfoArg * at );
+    DAS_API void builtin_map_file_records ( const FILE* _f, int32_t delimiter, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context*, LineInfoArg * at );
+    DAS_API void builtin_map_file_records_default ( const FILE* _f, int32_t delimiter, const TBlock<void, TTemporary<const char *>>& blk, Context*, LineInfoArg * at );
+    DAS_API void builtin_map_file_lines ( const FILE* _f, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context*, LineInfoArg * at );
+    DAS_API void builtin_map_file_lines_default ( const FILE* _f, const TBlock<void, TTemporary<const char *>>& blk, Context*, LineInfoArg * at );
     DAS_API char * builtin_dirname ( const char * name, Context * context, LineInfoArg * at );
     DAS_API char * builtin_basename ( const char * name, Context * context, LineInfoArg * at );
     DAS_API bool builtin_fstat ( const FILE * f, FStat & fs, Context * context, LineInfoArg * at );
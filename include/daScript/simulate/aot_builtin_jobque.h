@@ -70,27 +70,80 @@ namespace das {
         atomic<TT>  value;
     };
 
+    // clones of one context, which are reset between uses instead of being destroyed.
+    // pooled contexts keep their heap chunks, stack, and clone setup, so taking one is cheap.
+    // clones share code, functions, and shared globals with the prototype, which has to outlive the pool
+    class DAS_API ContextPool {
+    public:
+        ContextPool ( Context * proto, int32_t capacity );
+        ~ContextPool();
+        int32_t prewarm ( int32_t count );
+        shared_ptr<Context> acquire();
+        void release ( const shared_ptr<Context> & ctx );
+        int32_t available();
+    public:
+        // statistics
+        uint64_t    acquired = 0;       // contexts handed out
+        uint64_t    reused = 0;         // of them, taken from the pool
+        uint64_t    created = 0;        // contexts cloned from the prototype
+        uint64_t    discarded = 0;      // contexts destroyed on release, since the pool was full or the reset failed
+        uint64_t    createTime = 0;     // nanoseconds spent cloning
+        uint64_t    resetTime = 0;      // nanoseconds spent resetting
+    protected:
+        shared_ptr<Context> create();
+    protected:
+        Context *                   proto = nullptr;
+        int32_t                     capacity = 0;
+        mutex                       poolMutex;
+        vector<shared_ptr<Context>> pool;
+    };
+
     typedef AtomicTT<int32_t> AtomicInt;
     typedef AtomicTT<int64_t> AtomicInt64;
     using Atomic32 = AtomicTT<int32_t>;
     using Atomic64 = AtomicTT<int64_t>;
 
+    // slot of the bounded channel ring. seq tells whose turn it is:
+    // pos - slot is free for the producer of pos, pos+1 - slot holds item pos for the consumer
+    struct ChannelSlot {
+        atomic<uint64_t>    seq{0};
+        Feature             item;
+    };
+
+    struct ChannelItem {
+        void *      data;
+        TypeInfo *  type;
+        Context *   from;
+    };
+
     class DAS_API Channel : public JobStatus {
     public:
         Channel( Context * ctx ) : owner(ctx) { mTrackMagic = TRACK_CHANNEL; }
         Channel( Context * ctx, int count) : owner(ctx) { mTrackMagic = TRACK_CHANNEL; mRemaining = count; }
+        Channel( Context * ctx, int count, uint32_t capacity );    // bounded, lock-free
         virtual ~Channel();
         void push ( void * data, TypeInfo * ti, Context * context );
         void pushBatch ( void ** data, int count, TypeInfo * ti, Context * context );
         void pop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
         bool tryPop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
         bool popWithTimeout ( int timeoutMs, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        int popBatch ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        int tryPopBatch ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
         bool isEmpty() const;
         int total() const;
+        int capacity() const { return ring ? int(ringMask + 1) : 0; }
         Context * getOwner() { return owner; }
     public:
         template <typename TT>
         void for_each_item ( TT && tt ) {
+            if ( ring ) {
+                vector<ChannelItem> items;
+                ringSnapshot(items);
+                for ( auto & it : items ) {
+                    tt(it.data, it.type, it.from ? it.from : owner);
+                }
+                return;
+            }
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
                 tt(f.data, f.type, f.from ? f.from : owner);
@@ -98,6 +151,14 @@ namespace das {
         }
         template <typename TT>
         void gather ( TT && tt ) {
+            if ( ring ) {
+                vector<Feature> items;
+                takeAll(items);
+                for ( auto & f : items ) {
+                    tt(f.data, f.type, f.from ? f.from : owner);
+                }
+                return;
+            }
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
                 tt(f.data, f.type, f.from ? f.from : owner);
@@ -106,6 +167,20 @@ namespace das {
         }
         template <typename TT>
         void gatherEx ( Context * ctx, TT && tt ) {
+            if ( ring ) {
+                vector<Feature> items, rest;
+                takeAll(items);
+                for ( auto & f : items ) {
+                    auto itOwner = f.from ? f.from : owner;
+                    if ( itOwner == ctx ) {
+                        tt(f.data, f.type, itOwner);
+                    } else {
+                        rest.emplace_back(das::move(f));
+                    }
+                }
+                pushFeatures(rest);
+                return;
+            }
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto f = pipe.begin(); f != pipe.end(); ) {
                 auto itOwner = f->from ? f->from : owner;
@@ -119,6 +194,15 @@ namespace das {
         }
         template <typename TT>
         void gather_and_forward ( Channel * that, TT && tt ) {
+            if ( ring || that->ring ) {
+                vector<Feature> items;
+                takeAll(items);
+                for ( auto & f : items ) {
+                    tt(f.data, f.type, f.from ? f.from : owner);
+                }
+                that->pushFeatures(items);
+                return;
+            }
             lock_guard<mutex> guard(mCompleteMutex);
             for ( auto & f : pipe ) {
                 tt(f.data, f.type, f.from ? f.from : owner);
@@ -130,11 +214,36 @@ namespace das {
             pipe.clear();
             that->mCond.notify_all();  // notify_one??
         }
+    protected:
+        void takeAll ( vector<Feature> & items );
+        void pushFeatures ( vector<Feature> & items );
+        int ringClaim ( atomic<uint64_t> & cursor, uint64_t lag, int count, uint64_t & at );
+        void ringPush ( void ** data, int count, TypeInfo * ti, Context * pushCtx );
+        int ringPop ( int maxCount, int timeoutMs, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        int ringTryPop ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
+        void ringRelease ( uint64_t pos );
+        void ringWake();
+        bool ringHasItems() const;
+        bool ringCanPush() const;
+        void ringWaitForSpace();
+        void ringSnapshot ( vector<ChannelItem> & items ) const;
+        template <typename SpinTT, typename ParkTT>
+        bool ringWait ( SpinTT && spinReady, ParkTT && parkReady, uint32_t timeoutMs );
     protected:
         uint32_t            mSleepMs = 1;
         deque<Feature>      pipe;
         Feature             tail;
         Context *           owner = nullptr;
+        // bounded mode. producers and consumers only meet on the slot sequence numbers,
+        // mutex and condition variable are only touched when somebody is parked
+        ChannelSlot *       ring = nullptr;
+        uint64_t            ringMask = 0;
+        atomic<int32_t>     ringParked{0};
+        char                ringPad0[64];
+        atomic<uint64_t>    ringTail{0};
+        char                ringPad1[64];
+        atomic<uint64_t>    ringHead{0};
+        char                ringPad2[64];
     };
 
     class DAS_API Stream : public JobStatus {
@@ -178,7 +287,9 @@ namespace das {
     DAS_API void new_job_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo );
     DAS_API void new_thread_invoke ( Lambda lambda, Func fn, int32_t lambdaSize, Context * context, LineInfoArg * lineinfo );
     DAS_API void withJobQue ( const TBlock<void> & block, Context * context, LineInfoArg * lineInfo );
+    DAS_API void withJobQueBackend ( bool workStealing, const TBlock<void> & block, Context * context, LineInfoArg * lineInfo );
     DAS_API int getTotalHwJobs( Context * context, LineInfoArg * at );
+    DAS_API bool isWorkStealingJobQue( Context * context, LineInfoArg * at );
     DAS_API int getTotalHwThreads ();
     DAS_API void withJobStatus ( int32_t total, const TBlock<void,JobStatus *> & block, Context * context, LineInfoArg * lineInfo );
     DAS_API void jobStatusAddRef ( JobStatus * status, Context * context, LineInfoArg * at );
@@ -193,10 +304,15 @@ namespace das {
     DAS_API void channelPop ( Channel * ch, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
     DAS_API bool channelTryPop ( Channel * ch, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
     DAS_API bool channelPopWithTimeout ( Channel * ch, int32_t timeoutMs, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    DAS_API int32_t channelPopBatch ( Channel * ch, int32_t maxCount, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
+    DAS_API int32_t channelTryPopBatch ( Channel * ch, int32_t maxCount, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
     DAS_API int jobAppend ( JobStatus * ch, int size, Context * context, LineInfoArg * at );
     DAS_API void withChannel ( const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * lineinfo );
     DAS_API void withChannelEx ( int32_t count, const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * lineinfo );
     DAS_API Channel* channelCreate( Context * context, LineInfoArg * at);
+    DAS_API void withBoundedChannel ( int32_t capacity, const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * lineinfo );
+    DAS_API void withBoundedChannelEx ( int32_t capacity, int32_t count, const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * lineinfo );
+    DAS_API Channel* boundedChannelCreate( int32_t capacity, Context * context, LineInfoArg * at);
     DAS_API void channelRemove(Channel * & ch, Context * context, LineInfoArg * at);
     DAS_API void channelGather ( Channel * ch, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at );
     DAS_API void channelGatherEx ( Channel * ch, const TBlock<void,void *,const TypeInfo *,Context &> & blk, Context * context, LineInfoArg * at );
@@ -222,6 +338,10 @@ namespace das {
     DAS_API vec4f lockBoxFill ( Context & context, SimNode_CallBase * call, vec4f * args );
     DAS_API void lockBoxGrab ( LockBox * ch, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at );
     DAS_API void lockBoxUpdate ( LockBox * ch, TypeInfo * ti, const TBlock<void *,void*> & blk, Context * context, LineInfoArg * at );
+    DAS_API ContextPool * contextPoolCreate ( int32_t capacity, int32_t prewarm, Context * context, LineInfoArg * at );
+    DAS_API void contextPoolRemove ( ContextPool * & pool, Context * context, LineInfoArg * at );
+    DAS_API void withContextPool ( int32_t capacity, int32_t prewarm, const TBlock<void,ContextPool *> & blk, Context * context, LineInfoArg * at );
+    DAS_API void withPooledContext ( ContextPool * pool, const TBlock<void,Context &> & blk, Context * context, LineInfoArg * at );
 
     template <typename TT>
     AtomicTT<TT> * atomicCreate( Context *, LineInfoArg * ) {
@@ -207,6 +207,7 @@ namespace das
         void freeSourceData();
         virtual int64_t getFileMtime ( const string & fileName ) const;
         FileInfoPtr letGoOfFileInfo ( const string & fileName );
+        vector<string> getFileNames () const;
         virtual ModuleInfo getModuleInfo ( const string & req, const string & from ) const;
         virtual string getDynModulesFolder () const { return ""; }
         virtual bool isPodInScopeAllowed ( const string & /*moduleName*/, const string & /*fileName*/ ) const { return true; };
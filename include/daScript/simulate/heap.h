@@ -137,6 +137,8 @@ namespace das {
         virtual void report() = 0;
         virtual bool mark() = 0;
         virtual bool mark ( char * ptr, uint32_t size ) = 0;
+        virtual bool canMarkAtomic() const { return false; }
+        virtual bool markAtomic ( char *, uint32_t ) { DAS_ASSERT(0 && "not supported"); return false; }    // same as mark, but safe to call from several threads
         virtual void sweep() = 0;
         virtual bool isOwnPtr ( char * ptr, uint32_t size ) = 0;
         virtual bool isValidPtr ( char * ptr, uint32_t size ) = 0;  // only if isOwnPtr
@@ -283,6 +285,8 @@ namespace das {
         virtual void report() override;
         virtual bool mark() override;
         virtual bool mark ( char * ptr, uint32_t size ) override;
+        virtual bool canMarkAtomic() const override { return true; }
+        virtual bool markAtomic ( char * ptr, uint32_t size ) override;
         virtual bool isOwnPtr ( char * ptr, uint32_t size ) override;
         virtual bool isValidPtr ( char * ptr, uint32_t size ) override;
         virtual void setInitialSize ( uint32_t size ) override;
@@ -301,6 +305,45 @@ namespace das {
         MemoryModel model;
     };
 
+    // persistent heap, where small and medium allocations come from size class runs (see SizeClassModel).
+    // bigger allocations, or everything when tracking allocations, go to the MemoryModel big stuff
+    class DAS_API SizeClassHeapAllocator final : public AnyHeapAllocator {
+    public:
+        SizeClassHeapAllocator();
+        virtual char * impl_allocate ( uint32_t size ) override;
+        virtual void impl_free ( char * ptr, uint32_t size ) override;
+        virtual char * impl_reallocate ( char * ptr, uint32_t oldSize, uint32_t newSize ) override;
+        virtual int depth() const override;
+        virtual uint64_t bytesAllocated() const override;
+        virtual uint64_t totalAlignedMemoryAllocated() const override;
+        virtual void reset() override;
+        virtual void shrink() override;
+        virtual void report() override;
+        virtual bool mark() override;
+        virtual bool mark ( char * ptr, uint32_t size ) override;
+        virtual bool canMarkAtomic() const override { return true; }
+        virtual bool markAtomic ( char * ptr, uint32_t size ) override;
+        virtual void sweep() override;
+        virtual bool isOwnPtr ( char * ptr, uint32_t size ) override;
+        virtual bool isValidPtr ( char * ptr, uint32_t size ) override;
+        virtual void setInitialSize ( uint32_t size ) override;
+        virtual int32_t getInitialSize() const override;
+        virtual void setGrowFunction ( CustomGrowFunction && fun ) override;
+        virtual void setTrackAllocations ( bool on ) override;
+#if DAS_TRACK_ALLOCATIONS
+        virtual void impl_mark_location ( void * ptr, const LineInfo * at ) override { big.mark_location(ptr,at); }
+        virtual void impl_mark_comment ( void * ptr, const char * what ) override { big.mark_comment(ptr,what); }
+        virtual const char * impl_get_comment ( void * ptr ) const override { return big.get_comment(ptr); }
+#endif
+    protected:
+        __forceinline bool isSmall ( uint32_t size ) const { return size<=maxSmallAllocation; }
+        char * allocateSlot ( uint32_t size );
+        void freeSlot ( char * ptr, uint32_t size );
+        SizeClassModel  small;
+        MemoryModel     big;
+        uint32_t        maxSmallAllocation = DAS_MAX_SIZE_CLASS_ALLOCATION;
+    };
+
     class DAS_API LinearHeapAllocator final : public AnyHeapAllocator {
     public:
         LinearHeapAllocator() {}
@@ -367,6 +410,8 @@ namespace das {
         virtual void report() override;
         virtual bool mark() override;
         virtual bool mark ( char * ptr, uint32_t size ) override;
+        virtual bool canMarkAtomic() const override { return true; }
+        virtual bool markAtomic ( char * ptr, uint32_t size ) override;
         virtual void sweep() override;
         virtual bool isOwnPtr ( char * ptr, uint32_t size ) override;
         virtual bool isValidPtr ( char * ptr, uint32_t size ) override;
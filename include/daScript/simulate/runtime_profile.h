@@ -2,9 +2,47 @@
 
 #include "daScript/simulate/simulate.h"
 
+#include <thread>
+#include <condition_variable>
+
 namespace das
 {
     // profile(count,category,block) -> float time in sec
     DAS_API float builtin_profile ( int32_t count, const char * category, const Block & block, Context * context, LineInfoArg * at );
+
+    // Statistical sampling profiler.
+    // A watcher thread raises Context::sampleRequest every intervalUsec. The context thread picks the request up
+    // at the next frame push (interpreted call, block invoke, AOT or JIT prologue), where every frame on the stack
+    // is complete, and records the call stack, including the frame which is being entered. Nothing is recorded between samples.
+    struct SampleFrame {
+        enum : uint32_t { interpreted, aot, jit };
+        const void *    key;        // FuncInfo * for interpreted frames and blocks, function name for AOT and JIT frames
+        uint32_t        kind;
+        __forceinline bool operator < ( const SampleFrame & f ) const {
+            return key!=f.key ? key<f.key : kind<f.kind;
+        }
+    };
+
+    class DAS_API SamplingProfiler {
+    public:
+        SamplingProfiler ( Context * ctx, uint32_t intervalUsec );
+        ~SamplingProfiler();
+        void stop();                                    // joins the watcher thread, collected samples stay
+        void sample ( Context & ctx );                  // context thread only, at a safe point
+        void report ( TextWriter & tw ) const;          // folded stacks, one 'root;...;leaf count' line per unique stack
+        uint64_t totalSamples() const { return samples; }
+    protected:
+        void watch();
+    protected:
+        Context *                                   context;
+        uint32_t                                    interval;
+        thread                                      watcher;
+        mutable mutex                               lock;
+        condition_variable                          wakeUp;
+        bool                                        done = false;
+        das_safe_map<vector<SampleFrame>,uint64_t>  stacks;
+        vector<SampleFrame>                         frames;
+        uint64_t                                    samples = 0;
+    };
 }
 
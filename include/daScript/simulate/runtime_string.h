@@ -6,9 +6,11 @@
 namespace das
 {
     class Context;
+    class StringWriter;
 
     DAS_API string unescapeString ( const string & input, bool * error, bool das_escape = true );
     DAS_API string escapeString ( const string & input, bool das_escape = true );
+    DAS_API void escapeString ( StringWriter & ss, const char * str, size_t len, bool das_escape = true );
     DAS_API string to_cpp_double ( double val );
     DAS_API string to_cpp_float ( float val );
     DAS_API string reportError ( const struct LineInfo & li, const string & message, const string & extra,
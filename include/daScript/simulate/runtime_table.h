@@ -44,14 +44,94 @@ namespace das
         }
     };
 
+    // probing, which only looks at hashes. shared by TableHash and incremental table resize
+    struct TableProbe {
+#if DAS_TABLE_GROUP_PROBE
+        // hashes are probed in aligned groups of 8 slots. capacity is a power of 2 and at least TableHash::minCapacity,
+        // so a group never wraps around the end of the table. probe order is exactly the same as the scalar loop,
+        // lanes before the starting slot are masked out of the first group
+        enum {
+            groupSize = 8,
+            groupLanes = 0xff
+        };
+        static_assert(sizeof(TableHashKey)==4, "group probing expects 32-bit table hashes");
+        static __forceinline void loadGroup ( const TableHashKey * pHashes, vec4i & lo, vec4i & hi ) {
+            lo = v_ldui((const int *)pHashes);
+            hi = v_ldui((const int *)pHashes + 4);
+        }
+        static __forceinline uint32_t groupMask ( vec4i lo, vec4i hi, vec4i what ) {
+            return uint32_t(v_signmask(v_cast_vec4f(v_cmp_eqi(lo, what))))
+                | (uint32_t(v_signmask(v_cast_vec4f(v_cmp_eqi(hi, what)))) << 4);
+        }
+        // all lanes before the first set bit, or all lanes if there is none
+        static __forceinline uint32_t beforeFirst ( uint32_t bits ) {
+            return (bits & (0u - bits)) - 1u;
+        }
+#endif
+        static __forceinline uint32_t insertNew ( const TableHashKey * pHashes, uint32_t capacity, uint64_t hash ) {
+            // TODO: take key under account and be less aggressive?
+            DAS_ASSERT(hash>1);
+            uint32_t mask = capacity - 1;
+            uint32_t index = uint32_t(hash) & mask;
+#if DAS_TABLE_GROUP_PROBE
+            uint32_t group = index & ~uint32_t(groupSize-1);
+            uint32_t lanes = uint32_t(groupLanes) << (index - group);
+            while ( true ) {
+                vec4i lo, hi;
+                loadGroup(pHashes + group, lo, hi);
+                uint32_t empty = groupMask(lo, hi, v_zeroi()) & lanes;
+                if ( empty ) return group + das_ctz(empty);
+                group = (group + groupSize) & mask;
+                lanes = groupLanes;
+            }
+#else
+            while ( true ) {
+                auto kh = pHashes[index];
+                if ( kh==HASH_EMPTY64 ) {
+                    return index;
+                }
+                index = (index + 1) & mask;
+            }
+#endif
+        }
+    };
+
+    // incremental resize. when the table grows, previous storage is kept in resizeData, and its entries are moved
+    // into the new storage a few slots at a time on each insert or erase. lookups check both storages, entries found in the
+    // previous one are moved first, so indices are always into the current storage. locking or walking the table finishes the resize
+    // (parallel gc mark can't modify the table, so it walks both storages instead)
+    __forceinline char * table_resize_keys ( const Table & tab, uint32_t valueTypeSize ) {
+        return tab.resizeData + size_t(tab.resizeCapacity) * valueTypeSize;
+    }
+    __forceinline TableHashKey * table_resize_hashes ( const Table & tab, uint32_t valueTypeSize, uint32_t keyTypeSize ) {
+        return (TableHashKey *)(table_resize_keys(tab, valueTypeSize) + size_t(tab.resizeCapacity) * keyTypeSize);
+    }
+    __forceinline uint32_t table_resize_move ( Table & tab, uint32_t oldIndex, uint32_t valueTypeSize, uint32_t keyTypeSize ) {
+        auto oldKeys = table_resize_keys(tab, valueTypeSize);
+        auto oldHashes = table_resize_hashes(tab, valueTypeSize, keyTypeSize);
+        auto hash = oldHashes[oldIndex];
+        uint32_t index = TableProbe::insertNew(tab.hashes, tab.capacity, hash);
+        tab.hashes[index] = hash;
+        memcpy ( tab.keys + size_t(index)*keyTypeSize, oldKeys + size_t(oldIndex)*keyTypeSize, keyTypeSize );
+        memcpy ( tab.data + size_t(index)*valueTypeSize, tab.resizeData + size_t(oldIndex)*valueTypeSize, valueTypeSize );
+        oldHashes[oldIndex] = HASH_KILLED64;    // keeps probe chains of the previous storage intact
+        return index;
+    }
+    // moves up to 'budget' slots of the previous storage, frees it once everything is moved
+    DAS_API void table_resize_step ( Context * context, Table & tab, uint32_t valueTypeSize, uint32_t keyTypeSize, uint32_t budget, LineInfo * at );
+
     template <typename KeyType>
-    class TableHash {
+    class TableHash : TableProbe {
         Context *   context = nullptr;
         uint32_t    valueTypeSize = 0;
         enum {
             minCapacity = 8,
-            minLookups = 4
+            minLookups = 4,
+            resizeStep = 32     // slots of the previous storage moved per insert or erase, during incremental resize
         };
+#if DAS_TABLE_GROUP_PROBE
+        static_assert(int(minCapacity)>=int(groupSize), "group can't wrap around the table");
+#endif
     public:
         TableHash () = delete;
         TableHash ( const TableHash & ) = delete;
@@ -64,80 +144,39 @@ namespace das
 
         __forceinline int find ( const Table & tab, KeyType key, uint64_t hash ) const {
             DAS_ASSERT(hash>1);
-            if ( tab.capacity==0 ) return -1;
-            uint32_t mask = tab.capacity - 1;
-            uint32_t index = uint32_t(hash) & mask;
-            auto pKeys = (const KeyType *) tab.keys;
-            auto pHashes = tab.hashes;
-            auto hashKey = hashToHashKey(TableHashKey(hash));
-            while ( true ) {
-                auto kh = pHashes[index];
-                if ( kh==HASH_EMPTY64 ) {
-                    return -1;
-                } else if ( kh==hashKey && KeyCompare<KeyType>()(pKeys[index],key) ) {
-                    return (int) index;
-                }
-                index = (index + 1) & mask;
+            int index = probe((const KeyType *) tab.keys, tab.hashes, tab.capacity, key, hash);
+            if ( index==-1 && tab.resizeData ) {
+                // moving an entry between storages does not change table contents
+                index = findResizing(const_cast<Table &>(tab), key, hash);
             }
+            return index;
         }
 
         __forceinline int reserve ( Table & tab, KeyType key, uint64_t hash, LineInfo * at = nullptr ) {
             DAS_ASSERT(hash>1);
             if ( tab.size >= (tab.capacity/2) ) grow(tab, at);
             else if ( (tab.capacity-tab.size)/2 < tab.tombstones ) rehash(tab, at);
-            uint32_t mask = tab.capacity - 1;
-            uint32_t index = uint32_t(hash) & mask;
-            uint32_t insertI = -1u;
-            auto pKeys = (KeyType *) tab.keys;
-            auto pHashes = tab.hashes;
-            auto hashKey = hashToHashKey(TableHashKey(hash));
-            while ( true ) {
-                auto kh = pHashes[index];
-                if (kh == HASH_EMPTY64 ) {
-                    if ( tab.isLocked() ) context->throw_error_at(at, "can't insert into locked table");
-                    if ( insertI != -1u ) {
-                        index = insertI;
-                        tab.tombstones--;
-                    }
-                    pHashes[index] = hashKey;
-                    pKeys[index] = key;
-                    tab.size++;
-                    return (int)index;
-                } else if (kh == HASH_KILLED64) {
-                    if ( insertI == -1u ) insertI = index;
-                } else if (kh == hashKey && KeyCompare<KeyType>()(pKeys[index], key)) {
-                    return (int)index;
-                }
-                index = (index + 1) & mask;
+            if ( tab.resizeData ) {
+                int index = reserveResizing(tab, key, hash, at);
+                if ( index!=-1 ) return index;
             }
+            return reserveCurrent(tab, key, hash, at);
         }
 
         __forceinline int erase ( Table & tab, KeyType key, uint64_t hash ) {
-            DAS_ASSERT(hash>1);
-            if ( tab.capacity==0 ) return -1;
-            uint32_t mask = tab.capacity - 1;
-            uint32_t index = uint32_t(hash) & mask;
-            auto pKeys = (const KeyType *) tab.keys;
-            auto pHashes = tab.hashes;
-            auto hashKey = hashToHashKey(TableHashKey(hash));
-            while ( true ) {
-                auto kh = pHashes[index];
-                if ( kh==HASH_EMPTY64 ) {
-                    return -1;
-                } else if ( kh==hashKey && KeyCompare<KeyType>()(pKeys[index],key) ) {
-                    tab.size--;
-                    tab.tombstones++;
-                    pHashes[index] = HASH_KILLED64;
-                    memset(tab.data + index*valueTypeSize, 0, valueTypeSize);
-                    return (int) index;
-                }
-                index = (index + 1) & mask;
-            }
+            int index = find(tab, key, hash);
+            if ( index==-1 ) return -1;
+            tab.size--;
+            tab.tombstones++;
+            tab.hashes[index] = HASH_KILLED64;
+            memset(tab.data + index*valueTypeSize, 0, valueTypeSize);
+            if ( tab.resizeData ) table_resize_step(context, tab, valueTypeSize, sizeof(KeyType), resizeStep, nullptr);
+            return index;
         }
 
         bool grow ( Table & tab, LineInfo * at ) {
             uint32_t newCapacity = das::max(uint32_t(minCapacity), tab.capacity*2);
-            return reserveInternal(tab, newCapacity, at);
+            return reserveInternal(tab, newCapacity, at, context->incrementalTableResize);
         }
 
         bool rehash ( Table & tab, LineInfo * at ) {
@@ -158,27 +197,126 @@ namespace das
         }
 
     private:
-        __forceinline int insertNew ( Table & tab, uint64_t hash ) const {
-            // TODO: take key under account and be less aggressive?
-            DAS_ASSERT(hash>1);
-            uint32_t mask = tab.capacity - 1;
+        __forceinline int probe ( const KeyType * pKeys, const TableHashKey * pHashes, uint32_t capacity, KeyType key, uint64_t hash ) const {
+            if ( capacity==0 ) return -1;
+            uint32_t mask = capacity - 1;
             uint32_t index = uint32_t(hash) & mask;
-            auto pHashes = tab.hashes;
+            auto hashKey = hashToHashKey(TableHashKey(hash));
+#if DAS_TABLE_GROUP_PROBE
+            vec4i vkey = v_splatsi(int(hashKey));
+            uint32_t group = index & ~uint32_t(groupSize-1);
+            uint32_t lanes = uint32_t(groupLanes) << (index - group);
+            while ( true ) {
+                vec4i lo, hi;
+                loadGroup(pHashes + group, lo, hi);
+                uint32_t empty = groupMask(lo, hi, v_zeroi()) & lanes;
+                uint32_t match = groupMask(lo, hi, vkey) & lanes & beforeFirst(empty);
+                for ( ; match; match &= match - 1 ) {
+                    uint32_t slot = group + das_ctz(match);
+                    if ( KeyCompare<KeyType>()(pKeys[slot],key) ) return (int) slot;
+                }
+                if ( empty ) return -1;
+                group = (group + groupSize) & mask;
+                lanes = groupLanes;
+            }
+#else
             while ( true ) {
                 auto kh = pHashes[index];
                 if ( kh==HASH_EMPTY64 ) {
+                    return -1;
+                } else if ( kh==hashKey && KeyCompare<KeyType>()(pKeys[index],key) ) {
                     return (int) index;
                 }
                 index = (index + 1) & mask;
             }
+#endif
+        }
+
+        // key may still be in the previous storage, in which case it is moved to the current one
+        int findResizing ( Table & tab, KeyType key, uint64_t hash ) const {
+            auto oldKeys = (const KeyType *) table_resize_keys(tab, valueTypeSize);
+            auto oldHashes = (const TableHashKey *) (oldKeys + tab.resizeCapacity);
+            int oldIndex = probe(oldKeys, oldHashes, tab.resizeCapacity, key, hash);
+            if ( oldIndex==-1 ) return -1;
+            return (int) table_resize_move(tab, uint32_t(oldIndex), valueTypeSize, sizeof(KeyType));
+        }
+
+        int reserveResizing ( Table & tab, KeyType key, uint64_t hash, LineInfo * at ) {
+            int index = findResizing(tab, key, hash);
+            // moving only adds entries to the current storage, so index stays valid
+            table_resize_step(context, tab, valueTypeSize, sizeof(KeyType), resizeStep, at);
+            return index;
         }
 
-        bool reserveInternal(Table & tab, uint32_t newCapacity, LineInfo * at) {
+        __forceinline int reserveCurrent ( Table & tab, KeyType key, uint64_t hash, LineInfo * at ) {
+            uint32_t mask = tab.capacity - 1;
+            uint32_t index = uint32_t(hash) & mask;
+            uint32_t insertI = -1u;
+            auto pKeys = (KeyType *) tab.keys;
+            auto pHashes = tab.hashes;
+            auto hashKey = hashToHashKey(TableHashKey(hash));
+#if DAS_TABLE_GROUP_PROBE
+            vec4i vkey = v_splatsi(int(hashKey));
+            uint32_t group = index & ~uint32_t(groupSize-1);
+            uint32_t lanes = uint32_t(groupLanes) << (index - group);
+            while ( true ) {
+                vec4i lo, hi;
+                loadGroup(pHashes + group, lo, hi);
+                uint32_t empty = groupMask(lo, hi, v_zeroi()) & lanes;
+                uint32_t probed = lanes & beforeFirst(empty);
+                for ( uint32_t match = groupMask(lo, hi, vkey) & probed; match; match &= match - 1 ) {
+                    uint32_t slot = group + das_ctz(match);
+                    if ( KeyCompare<KeyType>()(pKeys[slot],key) ) return (int) slot;
+                }
+                if ( insertI == -1u ) {
+                    uint32_t killed = groupMask(lo, hi, v_splatsi(HASH_KILLED64)) & probed;
+                    if ( killed ) insertI = group + das_ctz(killed);
+                }
+                if ( empty ) {
+                    if ( tab.isLocked() ) context->throw_error_at(at, "can't insert into locked table");
+                    index = group + das_ctz(empty);
+                    if ( insertI != -1u ) {
+                        index = insertI;
+                        tab.tombstones--;
+                    }
+                    pHashes[index] = hashKey;
+                    pKeys[index] = key;
+                    tab.size++;
+                    return (int)index;
+                }
+                group = (group + groupSize) & mask;
+                lanes = groupLanes;
+            }
+#else
+            while ( true ) {
+                auto kh = pHashes[index];
+                if (kh == HASH_EMPTY64 ) {
+                    if ( tab.isLocked() ) context->throw_error_at(at, "can't insert into locked table");
+                    if ( insertI != -1u ) {
+                        index = insertI;
+                        tab.tombstones--;
+                    }
+                    pHashes[index] = hashKey;
+                    pKeys[index] = key;
+                    tab.size++;
+                    return (int)index;
+                } else if (kh == HASH_KILLED64) {
+                    if ( insertI == -1u ) insertI = index;
+                } else if (kh == hashKey && KeyCompare<KeyType>()(pKeys[index], key)) {
+                    return (int)index;
+                }
+                index = (index + 1) & mask;
+            }
+#endif
+        }
+
+        bool reserveInternal(Table & tab, uint32_t newCapacity, LineInfo * at, bool incremental = false) {
             DAS_VERIFYF((newCapacity & (newCapacity) - 1) == 0, "newCapacity must be power of 2, and not %i", int(newCapacity));
             if ( tab.magic!=0 || tab.lock!=0 ) {
                 context->throw_error_at(at, "can't grow a locked table");
                 return false;
             }
+            if ( tab.resizeData ) table_resize_step(context, tab, valueTypeSize, sizeof(KeyType), -1u, at);
             Table newTab;
             uint64_t memSize64 = uint64_t(newCapacity) * (uint64_t(valueTypeSize) + uint64_t(sizeof(KeyType)) + uint64_t(sizeof(TableHashKey)));
             if ( memSize64>=0xffffffff ) {
@@ -198,10 +336,16 @@ namespace das
             newTab.magic = 0;
             newTab.flags = tab.flags;
             newTab.tombstones = 0;
+            newTab.resizeData = nullptr;
+            newTab.resizeCapacity = 0;
+            newTab.resizeIndex = 0;
             if ( valueTypeSize ) memset(newTab.data, 0, size_t(newCapacity)*size_t(valueTypeSize));
             auto pHashes = newTab.hashes;
             memset(pHashes, 0, newCapacity * sizeof(TableHashKey));
-            if ( tab.size ) {
+            if ( tab.size && incremental ) {
+                newTab.resizeData = tab.data;
+                newTab.resizeCapacity = tab.capacity;
+            } else if ( tab.size ) {
                 auto pKeys = (KeyType *) newTab.keys;
                 auto pOldValues = tab.data;
                 auto pValues = newTab.data;
@@ -210,16 +354,20 @@ namespace das
                 for ( uint32_t i=0, is=tab.capacity; i!=is; ++i ) {
                     auto hash = pOldHashes[i];
                     if ( hash>HASH_KILLED64 ) {
-                        int index = insertNew(newTab, hash);
+                        uint32_t index = insertNew(pHashes, newCapacity, hash);
                         pHashes[index] = hash;
                         pKeys[index] = pOldKeys[i];
                         memcpy ( pValues + index*valueTypeSize, pOldValues + i*valueTypeSize, valueTypeSize );
                     }
                 }
             }
-            if (tab.capacity && !context->verySafeContext) {
+            if (tab.capacity && !newTab.resizeData) {
                 uint32_t oldSize = tab.capacity*(valueTypeSize + sizeof(KeyType) + sizeof(TableHashKey));
-                context->free(tab.data, oldSize, at);
+                if ( context->verySafeContext ) {
+                    context->retireStorage(tab.data, oldSize);
+                } else {
+                    context->free(tab.data, oldSize, at);
+                }
             }
             swap ( newTab, tab );
             return true;
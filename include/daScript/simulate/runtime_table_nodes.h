@@ -40,9 +40,14 @@ namespace das
             V_ARG(valueTypeSize);
             V_END();
         }
+        template <typename KeyType>
+        __forceinline uint64_t hashOfKey ( Context & context, KeyType key ) const {
+            return constKeyHash ? constKeyHash : hash_function(context, key);
+        }
         SimNode * tabExpr;
         SimNode * keyExpr;
         uint32_t valueTypeSize;
+        uint64_t constKeyHash = 0;  // hash of the constant key, computed once at simulation time. 0 if key is not constant
     };
 
     template <typename KeyType>
@@ -66,7 +71,7 @@ namespace das
             if ( tab->isLocked() ) context.throw_error_at(debugInfo, "can't insert to a locked table");
             auto key = EvalTT<KeyType>::eval(context,keyExpr);
             TableHash<KeyType> thh(&context,valueTypeSize);
-            auto hfn = hash_function(context, key);
+            auto hfn = hashOfKey(context, key);
             int index = thh.reserve(*tab, key, hfn, &debugInfo);    // if index==-1, it was a through, so safe to do
             return tab->data + index * valueTypeSize + offset;
         }
@@ -95,7 +100,7 @@ namespace das
             if (!tab) return nullptr;
             auto key = EvalTT<KeyType>::eval(context,PT::keyExpr);
             TableHash<KeyType> thh(&context,PT::valueTypeSize);
-            auto hfn = hash_function(context, key);
+            auto hfn = PT::hashOfKey(context, key);
             int index = thh.find(*tab, key, hfn);
             return index!=-1 ? tab->data + index * PT::valueTypeSize : nullptr;
         }
@@ -114,7 +119,7 @@ namespace das
             Table * tab = (Table *) tabExpr->evalPtr(context);
             if ( tab->isLocked() ) context.throw_error_at(debugInfo, "can't erase from locked table");
             auto key = EvalTT<KeyType>::eval(context,keyExpr);
-            auto hfn = hash_function(context, key);
+            auto hfn = hashOfKey(context, key);
             TableHash<KeyType> thh(&context,valueTypeSize);
             return thh.erase(*tab, key, hfn) != -1;
         }
@@ -132,7 +137,7 @@ namespace das
             Table * tab = (Table *) tabExpr->evalPtr(context);
             if ( tab->isLocked() ) context.throw_error_at(debugInfo, "can't insert to a locked table");
             auto key = EvalTT<KeyType>::eval(context,keyExpr);
-            auto hfn = hash_function(context, key);
+            auto hfn = hashOfKey(context, key);
             TableHash<KeyType> thh(&context,valueTypeSize);
             thh.reserve(*tab, key, hfn, &debugInfo);
             return v_zero();
@@ -151,7 +156,7 @@ namespace das
             DAS_PROFILE_NODE
             Table * tab = (Table *)tabExpr->evalPtr(context);
             auto key = EvalTT<KeyType>::eval(context,keyExpr);
-            auto hfn = hash_function(context, key);
+            auto hfn = hashOfKey(context, key);
             TableHash<KeyType> thh(&context,valueTypeSize);
             int index = thh.find(*tab, key, hfn);
             return index!=-1 ? tab->data + index * valueTypeSize : nullptr;
@@ -170,7 +175,7 @@ namespace das
             DAS_PROFILE_NODE
             Table * tab = (Table *)tabExpr->evalPtr(context);
             auto key = EvalTT<KeyType>::eval(context,keyExpr);
-            auto hfn = hash_function(context, key);
+            auto hfn = hashOfKey(context, key);
             TableHash<KeyType> thh(&context,valueTypeSize);
             return thh.find(*tab, key, hfn) != -1;
         }
@@ -24,6 +24,10 @@ namespace das
     #define DAS_ENABLE_STACK_WALK   1
     #endif
 
+    #ifndef DAS_ENABLE_SAMPLING_PROFILER
+    #define DAS_ENABLE_SAMPLING_PROFILER    DAS_ENABLE_STACK_WALK
+    #endif
+
     #ifndef DAS_ENABLE_EXCEPTIONS
     #define DAS_ENABLE_EXCEPTIONS   0
     #endif
@@ -34,6 +38,13 @@ namespace das
         #define DAS_PROFILE_NODE
     #endif
 
+    // sampling profiler safe point, placed right after the prologue of the new frame is written
+    #if DAS_ENABLE_SAMPLING_PROFILER
+        #define DAS_PROFILE_SAMPLE(context) if ( (context).sampleRequest ) (context).takeProfileSample();
+    #else
+        #define DAS_PROFILE_SAMPLE(context)
+    #endif
+
     #if DAS_ENABLE_KEEPALIVE
         #define DAS_KEEPALIVE_CALL(context) os_keepalive_call((context))
         #define DAS_KEEPALIVE_LOOP(context) os_keepalive_loop((context))
@@ -119,6 +130,8 @@ namespace das
         virtual bool rtti_node_isInstrument() const { return false; }
         virtual bool rtti_node_isInstrumentFunction() const { return false; }
         virtual bool rtti_node_isJit() const { return false; }
+        virtual bool rtti_node_isJitTierUp() const { return false; }
+        virtual bool rtti_node_isBytecode() const { return false; }
         virtual bool rtti_node_isKeepAlive() const { return false; }
         virtual bool rtti_node_isCallBase() const { return false; }
         virtual bool rtti_node_isErrorMessage() const { return false; }
@@ -309,6 +322,14 @@ namespace das
 
     typedef shared_ptr<Context> ContextPtr;
 
+    struct GcCollectStats {
+        uint32_t    collections = 0;    // total number of collectHeap calls
+        uint32_t    markUsec = 0;       // last collection
+        uint32_t    sweepUsec = 0;
+        uint32_t    markThreads = 0;    // threads, which took part in the mark phase
+        uint32_t    markTasks = 0;      // roots and chunks of large arrays and tables, distributed between threads
+    };
+
     // todo: Move this structs to separate file
     struct CodeOfPolicies;
     struct AnnotationArgumentList;
@@ -343,6 +364,16 @@ namespace das
 
         void makeWorkerFor(const Context & ctx);
 
+        // returns the clone to the state right after construction: runs finalizers, resets heaps, and runs
+        // the init script again. heap chunks stay allocated, so the next use does not grow them again.
+        // returns false when the init script fails
+        bool resetForReuse();
+
+        // hot patch from the freshly simulated context of the edited program. when both have the same functions,
+        // and the same layout of global variables and of the types functions work with, code of the changed functions
+        // is taken over, while globals and heap stay as they are. returns number of patched functions, or -1
+        int32_t hotPatchFrom ( const shared_ptr<Context> & ctx, TextWriter * log = nullptr );
+
         uint64_t getGlobalSize() const { return globalsSize; }
         uint64_t getSharedSize() const { return sharedSize; }
         void updateSharedGlobalSize(uint64_t sharedDiff, uint64_t globalDiff) {
@@ -456,6 +487,8 @@ namespace das
             heap->reset();
             stringHeap->reset();
             stringDisposeQue = nullptr;
+            retiredStorage.clear();
+            retiredBytes = 0;
         }
 
         __forceinline uint32_t tryRestartAndLock() {
@@ -538,6 +571,7 @@ namespace das
         string getStackWalk ( const LineInfo * at, bool showArguments, bool showLocalVariables, bool showOutOfScope = false, bool stackTopOnly = false );
         void runInitScript ();
         bool runShutdownScript ();
+        bool runInitScriptWithStack ();
 
         virtual void to_out ( const LineInfo * at, int level, const char * message );   // output to stdout or equivalent
         void to_out ( const LineInfo * at, const char * message ) {
@@ -584,6 +618,7 @@ namespace das
             pp->arguments = args;
             pp->cmres = nullptr;
             pp->line = line;
+            DAS_PROFILE_SAMPLE(*this);
 #endif
             // CALL
             fn->code->eval(*this);
@@ -625,6 +660,7 @@ namespace das
                 pp->arguments = args;
                 pp->cmres = nullptr;
                 pp->line = line;
+                DAS_PROFILE_SAMPLE(*this);
 #endif
                 // CALL
                 fn->code->eval(*this);
@@ -654,6 +690,7 @@ namespace das
             pp->arguments = args;
             pp->cmres = cmres;
             pp->line = line;
+            DAS_PROFILE_SAMPLE(*this);
 #endif
             // CALL
             fn->code->eval(*this);
@@ -683,6 +720,7 @@ namespace das
             pp->arguments = args;
             pp->cmres = cmres;
             pp->line = line;
+            DAS_PROFILE_SAMPLE(*this);
 #else
             stack.invoke(block.stackOffset, EP, SP);
 #endif
@@ -733,6 +771,7 @@ namespace das
             pp->arguments           = args;
             pp->cmres               = cmres;
             pp->line                = line;
+            DAS_PROFILE_SAMPLE(*this);
 #endif
             // CALL
             when(fn->code);
@@ -751,6 +790,12 @@ namespace das
         void announceCreation();
         void collectHeap(LineInfo * at, bool stringHeap, bool validate);
         void reportAnyHeap(LineInfo * at, bool sth, bool rgh, bool rghOnly, bool errorsOnly);
+        void collectRetired(LineInfo * at);     // frees retired storage, there should be no references into it
+        __forceinline void retireStorage ( char * data, uint32_t size ) {
+            retiredStorage.emplace_back(data, size);
+            retiredBytes += size;
+        }
+        GcCollectStats gcStats;
         void instrumentFunction ( SimFunction * , bool isInstrumenting, uint64_t userData, bool threadLocal );
         void instrumentContextNode ( const Block & blk, bool isInstrumenting, Context * context, LineInfo * line );
         void clearInstruments();
@@ -764,6 +809,11 @@ namespace das
         void resetProfiler();
         void collectProfileInfo( TextWriter & tout );
 
+        void startSampling ( uint32_t intervalUsec );       // statistical sampling profiler, see runtime_profile.h
+        void stopSampling();
+        uint64_t reportSamples ( TextWriter & tw ) const;   // folded stacks, returns total number of samples
+        ___noinline void takeProfileSample();
+
         vector<FileInfo *> getAllFiles() const;
 
         char * intern ( const char * str );
@@ -814,6 +864,8 @@ namespace das
         shared_ptr<NodeAllocator>       code;
         shared_ptr<DebugInfoAllocator>  debugInfo;
         char *                          stringDisposeQue = nullptr;
+        vector<pair<char *,uint32_t>>   retiredStorage;             // previous array and table storage, which very_safe_context did not free on grow
+        uint64_t                        retiredBytes = 0;
         uint64_t *                      annotationData = nullptr;
         char *                          globals = nullptr;
         char *                          shared = nullptr;
@@ -821,6 +873,7 @@ namespace das
         uint32_t                        fastCallDepth = 0;
         uint32_t                        insideContext = 0;
         bool                            persistent = false;
+        bool                            sizeClassHeap = false;      // persistent heap is SizeClassHeapAllocator
         bool                            ownStack = false;
         bool                            shutdown = false;
         bool                            breakOnException = false;
@@ -832,6 +885,8 @@ namespace das
         bool                            gcEnabled = false;
         bool                            failed = false;
         bool                            verySafeContext = false;    // when true, array and table reserves don't free memory
+        bool                            incrementalTableResize = false; // when true, table grow moves entries to the new storage a few at a time
+        bool                            parallelGcMark = false;     // when true, collectHeap marks on job que threads (if there is a job que)
         bool                            sharedPtrContext = false;   // there is a shared ptr to this context
     public:
         string                          name;
@@ -871,6 +926,8 @@ namespace das
         volatile bool   singleStepMode = false;
     public:
         bool            debugger = false;
+        volatile bool   sampleRequest = false;      // raised by the sampling profiler thread
+        class SamplingProfiler * sampler = nullptr;
     public:
         shared_ptr<das_hash_map<uint64_t,SimFunction *>> tabMnLookup;
         shared_ptr<das_hash_map<uint64_t,uint32_t>> tabGMnLookup;
@@ -897,6 +954,7 @@ namespace das
         };
         JitContext deleteJITOnFinish = {};
         vector<FileInfo*>  deleteUponFinish;
+        vector<shared_ptr<Context>> hotPatchSources;    // contexts which own the hot patched code
     };
 
     struct DebugAgentInstance {
@@ -1254,6 +1312,7 @@ __forceinline void profileNode ( SimNode * node ) {
         pp->arguments = args;
         pp->cmres = cmres;
         pp->line = line;
+        DAS_PROFILE_SAMPLE(*this);
 #else
         stack.invoke(block.stackOffset, EP, SP);
 #endif
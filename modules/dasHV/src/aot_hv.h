@@ -45,6 +45,9 @@ namespace das {
     void das_wss_head ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb, Context * context, LineInfoArg * at );
     void das_wss_any ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb, Context * context, LineInfoArg * at );
     void das_wss_sse ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb, Context * context, LineInfoArg * at );
+    void das_wss_set_workers ( Handle<hv::WebSocketServer> h, int32_t count, Context * context, LineInfoArg * at );
+    void das_wss_route ( Handle<hv::WebSocketServer> h, http_method method, const char * url, Func fn, Context * context, LineInfoArg * at );
+    void das_wss_post_to_main ( const char * msg, Context * context, LineInfoArg * at );
     void das_wss_static ( Handle<hv::WebSocketServer> h, const char * path, const char * dir );
     void das_wss_allow_cors ( Handle<hv::WebSocketServer> h );
     void das_wss_set_document_root ( Handle<hv::WebSocketServer> h, const char * dir );
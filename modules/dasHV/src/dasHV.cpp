@@ -1,6 +1,7 @@
 #include "daScript/misc/platform.h"
 
 #include <future>
+#include <thread>
 
 #include "../../../src/builtin/module_builtin_rtti.h"
 
@@ -15,6 +16,8 @@ IMPLEMENT_EXTERNAL_TYPE_FACTORY(HttpResponse,HttpResponse)
 IMPLEMENT_EXTERNAL_TYPE_FACTORY(HttpContext,hv::HttpContext)
 IMPLEMENT_EXTERNAL_TYPE_FACTORY(HttpResponseWriter,hv::HttpResponseWriter)
 
+das::Context* get_clone_context( das::Context * ctx, uint32_t category );//link time resolved dependencies
+
 namespace das {
 
 class Enumeration_ws_opcode : public das::Enumeration {
@@ -299,6 +302,11 @@ struct HttpResponseWriterAnnotation : ManagedStructureAnnotation<hv::HttpRespons
     }
 };
 
+class WebServer_Adapter;
+
+// server, whose worker route runs on this thread. post_to_main sends to it
+static thread_local WebServer_Adapter * g_worker_server = nullptr;
+
 class WebServer_Adapter : public hv::WebSocketServer, public HvWebServer_Adapter {
 public:
     WebServer_Adapter ( char * pClass, const StructInfo * info, Context * ctx )
@@ -356,6 +364,8 @@ public:
         };
     }
     ~WebServer_Adapter() {
+        // worker routes run in worker contexts, which go away with the adapter
+        if ( !workers.empty() ) stop();
         lock_guard<mutex> cguard(channel_lock);
         for ( auto & kv : channel_handles ) {
             HandleRegistry<hv::WebSocketChannel>::instance().release(kv.second);
@@ -532,6 +542,78 @@ public:
         lock_guard<mutex> guard(writer_lock);
         active_writers.erase(w);
     }
+    // multi-context dispatch. every libhv worker thread runs worker routes in its own clone of the context,
+    // which created the workers, so requests do not wait for tick() and for each other.
+    // clones share code and shared globals with that context, the rest of their state is their own
+    void SET_WORKERS ( int32_t count, Context * ctx, LineInfoArg * at ) {
+        if ( count < 1 ) ctx->throw_error_at(at, "set_workers: expecting at least one worker, got %i", count);
+        lock_guard<mutex> guard(worker_lock);
+        if ( !workers.empty() ) ctx->throw_error_at(at, "set_workers: workers are already created");
+        for ( int32_t i=0; i!=count; ++i ) {
+            auto worker = make_unique<Worker>();
+            worker->context.reset(get_clone_context(ctx, uint32_t(ContextCategory::thread_clone)));
+            workers.emplace_back(das::move(worker));
+        }
+        worker_env = daScriptEnvironment::getBound();
+        worker_threads = count;
+    }
+    void ROUTE ( http_method method, const char * relative_path, Func fn, Context * ctx, LineInfoArg * at ) {
+        if ( !fn ) ctx->throw_error_at(at, "route: function is null");
+        if ( workers.empty() ) ctx->throw_error_at(at, "route: set_workers has to be called before worker routes are registered");
+        lock_guard<mutex> guard(lock);
+        http_sync_handler handler = [this,fn](HttpRequest * req, HttpResponse * resp) -> int {
+            return invokeInWorker(fn, req, resp);
+        };
+        router.AddRoute(relative_path, method, handler);
+    }
+    void POST_TO_MAIN ( const char * msg ) {
+        string text = msg ? msg : "";
+        lock_guard<mutex> guard(lock);
+        que.emplace_back([this, text](){
+            onWorkerMessage(text);
+        });
+    }
+    void onWorkerMessage ( const string & msg ) {
+        lock_guard<mutex> guard(lock);
+        if ( auto fnOnWorkerMessage = get_onWorkerMessage(classPtr) ) {
+            invoke_onWorkerMessage(context,fnOnWorkerMessage,classPtr,(char *)msg.c_str());
+        }
+    }
+protected:
+    struct Worker {
+        shared_ptr<Context> context;
+        mutex               lock;
+    };
+    // libhv keeps connections on the same io thread, so threads are bound to workers on their first request.
+    // worker is only shared, when libhv runs more threads than there are workers
+    Worker & workerForThisThread() {
+        lock_guard<mutex> guard(worker_lock);
+        auto tid = std::this_thread::get_id();
+        auto it = worker_of_thread.find(tid);
+        if ( it != worker_of_thread.end() ) return *workers[it->second];
+        auto index = worker_of_thread.size() % workers.size();
+        worker_of_thread[tid] = index;
+        return *workers[index];
+    }
+    int invokeInWorker ( Func fn, HttpRequest * req, HttpResponse * resp ) {
+        auto & worker = workerForThisThread();
+        lock_guard<mutex> guard(worker.lock);
+        auto saved = daScriptEnvironment::exchangeBound(worker_env);
+        auto savedServer = g_worker_server;
+        g_worker_server = this;
+        auto ctx = worker.context.get();
+        int res = HTTP_STATUS_INTERNAL_SERVER_ERROR;
+        ctx->restart();
+        if ( !ctx->runWithCatch([&](){
+            res = das_invoke_function<int>::invoke<HttpRequest*,HttpResponse*>(ctx,nullptr,fn,req,resp);
+        }) ) {
+            ctx->to_err(&ctx->exceptionAt, ctx->getException());
+            ctx->clearException();
+        }
+        g_worker_server = savedServer;
+        daScriptEnvironment::setBound(saved);
+        return res;
+    }
 protected:
     HttpService router;
     WebSocketService service;
@@ -543,6 +625,10 @@ protected:
     map<hv::HttpResponseWriter*, HttpResponseWriterPtr>  active_writers;
     mutex       channel_lock;
     map<hv::WebSocketChannel*, Handle<hv::WebSocketChannel>>  channel_handles;
+    mutex       worker_lock;
+    vector<unique_ptr<Worker>>              workers;
+    map<std::thread::id, size_t>            worker_of_thread;
+    daScriptEnvironment *                   worker_env = nullptr;
 };
 
 string getDasRoot ( void );
@@ -653,6 +739,19 @@ void das_wss_sse ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb,
     if ( auto adapter = lookup_server(h) ) adapter->SSE(url, lmb, context, at);
 }
 
+void das_wss_set_workers ( Handle<hv::WebSocketServer> h, int32_t count, Context * context, LineInfoArg * at ) {
+    if ( auto adapter = lookup_server(h) ) adapter->SET_WORKERS(count, context, at);
+}
+
+void das_wss_route ( Handle<hv::WebSocketServer> h, http_method method, const char * url, Func fn, Context * context, LineInfoArg * at ) {
+    if ( auto adapter = lookup_server(h) ) adapter->ROUTE(method, url ? url : "/", fn, context, at);
+}
+
+void das_wss_post_to_main ( const char * msg, Context * context, LineInfoArg * at ) {
+    if ( !g_worker_server ) context->throw_error_at(at, "post_to_main: only worker routes can post to the main context");
+    g_worker_server->POST_TO_MAIN(msg);
+}
+
 // HttpResponseWriter operations
 
 int das_writer_end_headers ( hv::HttpResponseWriter * w, const char * key, const char * value ) {
@@ -750,7 +849,13 @@ void das_httpr_set_header ( HttpRequest * req, const char * key, const char * va
     req->SetHeader(key ? key : "", value ? value : value);
 }
 
-http_headers das_req_table_to_headers ( const TTable<char *,char *> & tab) {
+// headers are read straight from table storage, so any pending incremental resize is finished first
+static void das_req_table_settle ( const TTable<char *,char *> & tab, Context * context, LineInfoArg * at ) {
+    if ( tab.resizeData ) table_finish_resize(context, const_cast<TTable<char *,char *> &>(tab), at);
+}
+
+http_headers das_req_table_to_headers ( const TTable<char *,char *> & tab, Context * context, LineInfoArg * at ) {
+    das_req_table_settle(tab, context, at);
     http_headers headers;
     char ** keys = (char **)tab.keys;
     char ** values = (char **)tab.data;
@@ -769,7 +874,7 @@ void das_req_GET ( const char * url, const TBlock<void,HttpResponse*> & block, C
 }
 
 void das_req_GET_H ( const char * url, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::get(url ? url : "", headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -780,7 +885,7 @@ void das_req_POST ( const char * url, const char * text, const TBlock<void,HttpR
 }
 
 void das_req_POST_H ( const char * url, const char * text, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::post(url ? url : "", text ? text : "",headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -791,8 +896,9 @@ void das_req_POST_HF ( const char * url, const char * text, const TTable<char *,
     Request req(new HttpRequest);
     req->method = HTTP_POST;
     req->url = url ? url : "";
-    req->headers =das_req_table_to_headers(tab);
+    req->headers =das_req_table_to_headers(tab, context, at);
     req->body = text ? text : "";
+    das_req_table_settle(from, context, at);
     char ** keys = (char **)from.keys;
     char ** values = (char **)from.data;
     auto * hashes = (TableHashKey *)from.hashes;
@@ -821,7 +927,7 @@ void das_req_PUT ( const char * url, const char * text, const TBlock<void,HttpRe
 }
 
 void das_req_PUT_H ( const char * url, const char * text, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::put(url ? url : "", text ? text : "",headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -832,8 +938,9 @@ void das_req_PUT_HF ( const char * url, const char * text, const TTable<char *,c
     Request req(new HttpRequest);
     req->method = HTTP_PUT;
     req->url = url ? url : "";
-    req->headers = das_req_table_to_headers(tab);
+    req->headers = das_req_table_to_headers(tab, context, at);
     req->body = text ? text : "";
+    das_req_table_settle(from, context, at);
     char ** keys = (char **)from.keys;
     char ** values = (char **)from.data;
     auto * hashes = (TableHashKey *)from.hashes;
@@ -862,7 +969,7 @@ void das_req_PATCH ( const char * url, const char * text, const TBlock<void,Http
 }
 
 void das_req_PATCH_H ( const char * url, const char * text, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::patch(url ? url : "", text ? text : "",headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -873,8 +980,9 @@ void das_req_PATCH_HF ( const char * url, const char * text, const TTable<char *
     Request req(new HttpRequest);
     req->method = HTTP_PATCH;
     req->url = url ? url : "";
-    req->headers = das_req_table_to_headers(tab);
+    req->headers = das_req_table_to_headers(tab, context, at);
     req->body = text ? text : "";
+    das_req_table_settle(from, context, at);
     char ** keys = (char **)from.keys;
     char ** values = (char **)from.data;
     auto * hashes = (TableHashKey *)from.hashes;
@@ -903,7 +1011,7 @@ void das_req_DELETE ( const char * url, const TBlock<void,HttpResponse*> & block
 }
 
 void das_req_DELETE_H ( const char * url, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::Delete(url ? url : "", headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -915,7 +1023,7 @@ void das_req_HEAD ( const char * url, const TBlock<void,HttpResponse*> & block,
 }
 
 void das_req_HEAD_H ( const char * url, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at ) {
-    auto headers = das_req_table_to_headers(tab);
+    auto headers = das_req_table_to_headers(tab, context, at);
     auto resp = requests::head(url ? url : "", headers);
     das_invoke<void>::invoke<HttpResponse*>(context,at,block,resp.get());
 }
@@ -1253,6 +1361,15 @@ public:
         addExtern<DAS_BIND_FUN(das_wss_any)> (*this, lib, "ANY",
             SideEffects::worstDefault, "das_wss_any")
                 ->args({"server","url","lambda","context","at"})->unsafeOperation = true;
+        addExtern<DAS_BIND_FUN(das_wss_set_workers)> (*this, lib, "set_workers",
+            SideEffects::worstDefault, "das_wss_set_workers")
+                ->args({"server","count","context","at"});
+        addExtern<DAS_BIND_FUN(das_wss_route)> (*this, lib, "route",
+            SideEffects::worstDefault, "das_wss_route")
+                ->args({"server","method","url","function","context","at"});
+        addExtern<DAS_BIND_FUN(das_wss_post_to_main)> (*this, lib, "post_to_main",
+            SideEffects::worstDefault, "das_wss_post_to_main")
+                ->args({"msg","context","at"});
         addExtern<DAS_BIND_FUN(das_wss_static)> (*this, lib, "STATIC",
             SideEffects::worstDefault, "das_wss_static")
                 ->args({"server","path","dir"});
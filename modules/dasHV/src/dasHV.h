@@ -52,6 +52,9 @@ void das_wss_any ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb,
 void das_wss_static ( Handle<hv::WebSocketServer> h, const char * path, const char * dir );
 void das_wss_allow_cors ( Handle<hv::WebSocketServer> h );
 void das_wss_sse ( Handle<hv::WebSocketServer> h, const char * url, Lambda lmb, Context * context, LineInfoArg * at );
+void das_wss_set_workers ( Handle<hv::WebSocketServer> h, int32_t count, Context * context, LineInfoArg * at );
+void das_wss_route ( Handle<hv::WebSocketServer> h, http_method method, const char * url, Func fn, Context * context, LineInfoArg * at );
+void das_wss_post_to_main ( const char * msg, Context * context, LineInfoArg * at );
 
 // HttpResponseWriter operations
 int das_writer_end_headers ( hv::HttpResponseWriter * w, const char * key, const char * value );
@@ -69,7 +72,7 @@ http_status das_resp_data ( HttpResponse * resp, const char * data, int32_t len,
 void das_resp_set_header ( HttpResponse * resp, const char * key, const char * value );
 void das_resp_set_content_type ( HttpResponse * resp, const char * ct );
 
-http_headers das_req_table_to_headers ( const TTable<char *,char *> & tab );
+http_headers das_req_table_to_headers ( const TTable<char *,char *> & tab, Context * context, LineInfoArg * at );
 void das_req_GET ( const char * url, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at );
 void das_req_GET_H ( const char * url, const TTable<char *,char *> & tab, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at );
 void das_req_POST ( const char * url, const char * text, const TBlock<void,HttpResponse*> & block, Context * context, LineInfoArg * at );
@@ -0,0 +1,757 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/ast/ast.h"
+#include "daScript/ast/ast_expressions.h"
+#include "daScript/simulate/sim_policy.h"
+#include "daScript/simulate/simulate_visit_op.h"
+
+namespace das {
+
+    // Register bytecode.
+    //  Functions, which only work with int, float, and bool values, can be lowered into a flat array
+    //  of three-address instructions over a register file. Registers live in the stack frame of the function,
+    //  right after the prologue, so the Context stack, SimFunction, and the calling convention stay the same.
+    //  Calls go through Context::callOrFastcall, and everything else (AOT, JIT, debugger, instrumentation)
+    //  sees an ordinary SimFunction, whose code happens to be SimNode_Bytecode.
+
+    enum class BcOp : uint32_t {
+        Move,
+        AddI, SubI, MulI, DivI, ModI, AndI, OrI, XorI, ShlI, ShrI, NegI, NotI,
+        EqI, NeI, LtI, LeI, GtI, GeI,
+        AddF, SubF, MulF, DivF, ModF, NegF,
+        EqF, NeF, LtF, LeF, GtF, GeF,
+        NotB, IntToFloat, FloatToInt,
+        Jump, JumpIfTrue, JumpIfFalse,
+        JumpEqI, JumpNeI, JumpLtI, JumpLeI, JumpGtI, JumpGeI,
+        LoopI,
+        Call, Return, ReturnVoid,
+        Total
+    };
+
+    struct BcInstr {
+        BcOp        op;
+        int32_t     a, b, c;    // destination first, then operands. jumps store target instruction in 'c'
+    };
+
+    union BcReg {
+        int32_t     i;
+        float       f;
+    };
+
+    struct SimNode_Bytecode : SimNode {
+        SimNode_Bytecode ( const LineInfo & at ) : SimNode(at) {}
+        virtual SimNode * visit ( SimVisitor & vis ) override;
+        DAS_EVAL_ABI virtual vec4f eval ( Context & context ) override;
+        virtual bool rtti_node_isBytecode() const override { return true; }
+        BcInstr *   code = nullptr;
+        LineInfo *  codeAt = nullptr;       // one per instruction, for errors and calls
+        BcReg *     constants = nullptr;    // initial values of the constant registers
+        uint32_t    nArguments = 0;
+        uint32_t    firstConstant = 0;
+        uint32_t    nConstants = 0;
+        uint32_t    nInstructions = 0;
+        // saved original node
+        SimNode *   saved_code = nullptr;
+    };
+
+    SimNode * SimNode_Bytecode::visit ( SimVisitor & vis ) {
+        V_BEGIN();
+        V_OP(Bytecode);
+        V_ARG(nInstructions);
+        V_SUB(saved_code);
+        V_END();
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define DAS_BYTECODE_COMPUTED_GOTO  1
+#else
+    #define DAS_BYTECODE_COMPUTED_GOTO  0
+#endif
+
+    DAS_EVAL_ABI vec4f SimNode_Bytecode::eval ( Context & context ) {
+        BcReg * __restrict regs = (BcReg *)(context.stack.sp() + sizeof(Prologue));
+        vec4f * args = context.abiArguments();
+        for ( uint32_t i=0; i!=nArguments; ++i ) {
+            regs[i].i = v_extract_xi(v_cast_vec4i(args[i]));
+        }
+        memcpy(regs + firstConstant, constants, nConstants * sizeof(BcReg));
+        const BcInstr * __restrict ip = code;
+#if DAS_BYTECODE_COMPUTED_GOTO
+        static const void * labels[] = {
+            &&op_Move,
+            &&op_AddI, &&op_SubI, &&op_MulI, &&op_DivI, &&op_ModI, &&op_AndI, &&op_OrI, &&op_XorI, &&op_ShlI, &&op_ShrI, &&op_NegI, &&op_NotI,
+            &&op_EqI, &&op_NeI, &&op_LtI, &&op_LeI, &&op_GtI, &&op_GeI,
+            &&op_AddF, &&op_SubF, &&op_MulF, &&op_DivF, &&op_ModF, &&op_NegF,
+            &&op_EqF, &&op_NeF, &&op_LtF, &&op_LeF, &&op_GtF, &&op_GeF,
+            &&op_NotB, &&op_IntToFloat, &&op_FloatToInt,
+            &&op_Jump, &&op_JumpIfTrue, &&op_JumpIfFalse,
+            &&op_JumpEqI, &&op_JumpNeI, &&op_JumpLtI, &&op_JumpLeI, &&op_JumpGtI, &&op_JumpGeI,
+            &&op_LoopI,
+            &&op_Call, &&op_Return, &&op_ReturnVoid,
+        };
+        static_assert(sizeof(labels)/sizeof(labels[0])==size_t(BcOp::Total), "bytecode label table is out of sync");
+        #define BC_CASE(x)      op_##x:
+        #define BC_NEXT         goto *labels[uint32_t((++ip)->op)];
+        #define BC_JUMP(t)      { ip = code + (t); goto *labels[uint32_t(ip->op)]; }
+        goto *labels[uint32_t(ip->op)];
+#else
+        #define BC_CASE(x)      case BcOp::x:
+        #define BC_NEXT         ++ip; continue;
+        #define BC_JUMP(t)      { ip = code + (t); continue; }
+        for ( ;; ) switch ( ip->op ) {
+#endif
+        #define BC_AT           (codeAt + (ip - code))
+        #define BC_OP2(name,fld,expr) \
+            BC_CASE(name) { auto l = regs[ip->b].fld; auto r = regs[ip->c].fld; (void)l; (void)r; expr; BC_NEXT }
+        BC_CASE(Move)       { regs[ip->a] = regs[ip->b]; BC_NEXT }
+        BC_OP2(AddI, i, regs[ip->a].i = int32_t(uint32_t(l) + uint32_t(r)))
+        BC_OP2(SubI, i, regs[ip->a].i = int32_t(uint32_t(l) - uint32_t(r)))
+        BC_OP2(MulI, i, regs[ip->a].i = int32_t(uint32_t(l) * uint32_t(r)))
+        BC_OP2(DivI, i, regs[ip->a].i = SimPolicy<int32_t>::Div(l, r, context, BC_AT))
+        BC_OP2(ModI, i, regs[ip->a].i = SimPolicy<int32_t>::Mod(l, r, context, BC_AT))
+        BC_OP2(AndI, i, regs[ip->a].i = l & r)
+        BC_OP2(OrI,  i, regs[ip->a].i = l | r)
+        BC_OP2(XorI, i, regs[ip->a].i = l ^ r)
+        BC_OP2(ShlI, i, regs[ip->a].i = SimPolicy<int32_t>::BinShl(l, r, context, BC_AT))
+        BC_OP2(ShrI, i, regs[ip->a].i = SimPolicy<int32_t>::BinShr(l, r, context, BC_AT))
+        BC_CASE(NegI)       { regs[ip->a].i = int32_t(0u - uint32_t(regs[ip->b].i)); BC_NEXT }
+        BC_CASE(NotI)       { regs[ip->a].i = ~regs[ip->b].i; BC_NEXT }
+        BC_OP2(EqI, i, regs[ip->a].i = l == r)
+        BC_OP2(NeI, i, regs[ip->a].i = l != r)
+        BC_OP2(LtI, i, regs[ip->a].i = l < r)
+        BC_OP2(LeI, i, regs[ip->a].i = l <= r)
+        BC_OP2(GtI, i, regs[ip->a].i = l > r)
+        BC_OP2(GeI, i, regs[ip->a].i = l >= r)
+        BC_OP2(AddF, f, regs[ip->a].f = l + r)
+        BC_OP2(SubF, f, regs[ip->a].f = l - r)
+        BC_OP2(MulF, f, regs[ip->a].f = l * r)
+        BC_OP2(DivF, f, regs[ip->a].f = SimPolicy<float>::Div(l, r, context, BC_AT))
+        BC_OP2(ModF, f, regs[ip->a].f = SimPolicy<float>::Mod(l, r, context, BC_AT))
+        BC_CASE(NegF)       { regs[ip->a].f = -regs[ip->b].f; BC_NEXT }
+        BC_OP2(EqF, f, regs[ip->a].i = l == r)
+        BC_OP2(NeF, f, regs[ip->a].i = l != r)
+        BC_OP2(LtF, f, regs[ip->a].i = l < r)
+        BC_OP2(LeF, f, regs[ip->a].i = l <= r)
+        BC_OP2(GtF, f, regs[ip->a].i = l > r)
+        BC_OP2(GeF, f, regs[ip->a].i = l >= r)
+        BC_CASE(NotB)       { regs[ip->a].i = !regs[ip->b].i; BC_NEXT }
+        BC_CASE(IntToFloat) { regs[ip->a].f = float(regs[ip->b].i); BC_NEXT }
+        BC_CASE(FloatToInt) { regs[ip->a].i = int32_t(regs[ip->b].f); BC_NEXT }
+        BC_CASE(Jump)       BC_JUMP(ip->c)
+        BC_CASE(JumpIfTrue)  { if ( regs[ip->a].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpIfFalse) { if ( !regs[ip->a].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpEqI)    { if ( regs[ip->a].i == regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpNeI)    { if ( regs[ip->a].i != regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpLtI)    { if ( regs[ip->a].i <  regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpLeI)    { if ( regs[ip->a].i <= regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpGtI)    { if ( regs[ip->a].i >  regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(JumpGeI)    { if ( regs[ip->a].i >= regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(LoopI)      { if ( ++regs[ip->a].i < regs[ip->b].i ) BC_JUMP(ip->c); BC_NEXT }
+        BC_CASE(Call) {
+            // b is function index, c is the first argument register. arguments are consecutive
+            SimFunction * fn = context.getFunction(ip->b);
+            uint32_t nArgs = fn->debugInfo->count;
+            vec4f argValues[DAS_MAX_FUNCTION_ARGUMENTS];
+            for ( uint32_t i=0; i!=nArgs; ++i ) {
+                argValues[i] = v_cast_vec4f(v_seti_x(regs[ip->c + i].i));
+            }
+            vec4f res = context.callOrFastcall(fn, argValues, BC_AT);
+            if ( ip->a>=0 ) regs[ip->a].i = v_extract_xi(v_cast_vec4i(res));
+            BC_NEXT
+        }
+        BC_CASE(Return) {
+            context.abiResult() = v_cast_vec4f(v_seti_x(regs[ip->a].i));
+            return context.abiResult();
+        }
+        BC_CASE(ReturnVoid) {
+            return v_zero();
+        }
+#if !DAS_BYTECODE_COMPUTED_GOTO
+        }
+#endif
+        #undef BC_OP2
+        #undef BC_AT
+        #undef BC_JUMP
+        #undef BC_NEXT
+        #undef BC_CASE
+    }
+
+    enum class BcKind { none, i, f, b };
+
+    static BcKind bytecodeKind ( const TypeDecl * type ) {
+        if ( !type || type->dim.size() || type->ref ) return BcKind::none;
+        switch ( type->baseType ) {
+        case Type::tInt:    return BcKind::i;
+        case Type::tFloat:  return BcKind::f;
+        case Type::tBool:   return BcKind::b;
+        default:            return BcKind::none;
+        }
+    }
+
+    // values, which are passed to bytecode by value. the type of the expression itself may be a reference
+    static BcKind bytecodeValueKind ( const TypeDecl * type ) {
+        if ( !type || type->dim.size() ) return BcKind::none;
+        switch ( type->baseType ) {
+        case Type::tInt:    return BcKind::i;
+        case Type::tFloat:  return BcKind::f;
+        case Type::tBool:   return BcKind::b;
+        default:            return BcKind::none;
+        }
+    }
+
+    static bool isBytecodeCallable ( Function * fn ) {
+        if ( !fn || fn->builtIn || fn->index<0 ) return false;
+        if ( !fn->result->isVoid() && bytecodeKind(fn->result)==BcKind::none ) return false;
+        if ( fn->arguments.size() > DAS_MAX_FUNCTION_ARGUMENTS ) return false;
+        for ( auto & arg : fn->arguments ) {
+            if ( bytecodeKind(arg->type)==BcKind::none ) return false;
+        }
+        return true;
+    }
+
+    class BytecodeCompiler {
+    public:
+        BytecodeCompiler ( Function * f ) : func(f) {}
+        bool compile();
+    public:
+        Function *                      func;
+        vector<BcInstr>                 code;
+        vector<LineInfo>                codeAt;
+        vector<BcReg>                   constants;
+        uint32_t                        nArguments = 0;
+        int32_t                         regTop = 0;
+        int32_t                         regMax = 0;
+    protected:
+        struct Loop {
+            vector<int32_t>     breaks;
+            vector<int32_t>     continues;
+        };
+        das_hash_map<const Variable *,int32_t>  vars;
+        das_hash_map<int32_t,int32_t>           intConstants;
+        das_hash_map<uint32_t,int32_t>          floatConstants;
+        vector<Loop>                            loops;
+        bool                                    failed = false;
+    protected:
+        int32_t fail() { failed = true; return 0; }
+        int32_t allocReg() { int32_t r = regTop++; regMax = das::max(regMax, regTop); return r; }
+        int32_t emit ( BcOp op, const LineInfo & at, int32_t a, int32_t b = 0, int32_t c = 0 ) {
+            code.push_back({op, a, b, c});
+            codeAt.push_back(at);
+            return int32_t(code.size()) - 1;
+        }
+        int32_t here() const { return int32_t(code.size()); }
+        void patch ( const vector<int32_t> & jumps, int32_t target ) {
+            for ( auto j : jumps ) code[j].c = target;
+        }
+        // constants live in registers, which are filled on entry. until the register file is complete
+        // they are numbered -1, -2, ... and fixed up in 'finalize'
+        int32_t constInt ( int32_t value ) {
+            auto it = intConstants.find(value);
+            if ( it!=intConstants.end() ) return it->second;
+            BcReg reg; reg.i = value;
+            constants.push_back(reg);
+            return intConstants[value] = -int32_t(constants.size());
+        }
+        int32_t constFloat ( float value ) {
+            BcReg reg; reg.f = value;
+            auto it = floatConstants.find(uint32_t(reg.i));
+            if ( it!=floatConstants.end() ) return it->second;
+            constants.push_back(reg);
+            return floatConstants[uint32_t(reg.i)] = -int32_t(constants.size());
+        }
+        void finalize();
+        int32_t variable ( Expression * expr );
+        int32_t expr ( Expression * expr, int32_t dst = -1 );
+        int32_t exprOp1 ( ExprOp1 * expr, int32_t dst );
+        int32_t exprOp2 ( ExprOp2 * expr, int32_t dst );
+        int32_t exprCall ( ExprCall * expr, int32_t dst );
+        void branch ( Expression * cond, bool jumpIf, vector<int32_t> & jumps );
+        void statement ( Expression * expr );
+        void block ( ExprBlock * blk );
+        void forLoop ( ExprFor * expr );
+        int32_t target ( int32_t dst ) { return dst>=0 ? dst : allocReg(); }
+    };
+
+    int32_t BytecodeCompiler::variable ( Expression * expr ) {
+        if ( expr->rtti_isR2V() ) expr = static_cast<ExprRef2Value *>(expr)->subexpr;
+        if ( !expr->rtti_isVar() ) return fail();
+        auto evar = static_cast<ExprVar *>(expr);
+        auto it = vars.find(evar->variable);
+        if ( it==vars.end() ) return fail();    // globals, block arguments, captured variables
+        return it->second;
+    }
+
+    int32_t BytecodeCompiler::expr ( Expression * expr, int32_t dst ) {
+        if ( failed ) return 0;
+        auto kind = bytecodeValueKind(expr->type);
+        if ( kind==BcKind::none ) return fail();
+        int32_t src = -1;
+        if ( expr->rtti_isConstant() ) {
+            auto cexpr = static_cast<ExprConst *>(expr);
+            switch ( cexpr->baseType ) {
+            case Type::tInt:    src = constInt(cast<int32_t>::to(cexpr->value)); break;
+            case Type::tBool:   src = constInt(cast<bool>::to(cexpr->value) ? 1 : 0); break;
+            case Type::tFloat:  src = constFloat(cast<float>::to(cexpr->value)); break;
+            default:            return fail();
+            }
+        } else if ( expr->rtti_isVar() || expr->rtti_isR2V() ) {
+            src = variable(expr);
+        } else if ( expr->rtti_isOp1() ) {
+            return exprOp1(static_cast<ExprOp1 *>(expr), dst);
+        } else if ( expr->rtti_isOp2() ) {
+            return exprOp2(static_cast<ExprOp2 *>(expr), dst);
+        } else if ( expr->rtti_isOp3() ) {
+            auto op3 = static_cast<ExprOp3 *>(expr);
+            // branches write the result one at a time, so it goes through a temporary
+            int32_t res = allocReg();
+            vector<int32_t> onFalse, toEnd;
+            branch(op3->subexpr, false, onFalse);
+            this->expr(op3->left, res);
+            toEnd.push_back(emit(BcOp::Jump, op3->at, 0));
+            patch(onFalse, here());
+            this->expr(op3->right, res);
+            patch(toEnd, here());
+            if ( dst>=0 ) emit(BcOp::Move, op3->at, dst, res);
+            return dst>=0 ? dst : res;
+        } else if ( expr->rtti_isCall() ) {
+            return exprCall(static_cast<ExprCall *>(expr), dst);
+        } else {
+            return fail();
+        }
+        if ( failed ) return 0;
+        if ( dst>=0 && dst!=src ) {
+            emit(BcOp::Move, expr->at, dst, src);
+            return dst;
+        }
+        return src;
+    }
+
+    int32_t BytecodeCompiler::exprOp1 ( ExprOp1 * op1, int32_t dst ) {
+        if ( !op1->func || !op1->func->builtIn ) return fail();
+        auto kind = bytecodeValueKind(op1->subexpr->type);
+        const auto & name = op1->func->name;
+        if ( name=="++" || name=="--" || name=="+++" || name=="---" ) {
+            if ( kind!=BcKind::i ) return fail();
+            int32_t var = variable(op1->subexpr);
+            if ( failed ) return 0;
+            bool post = name.size()==3;
+            auto op = name[0]=='+' ? BcOp::AddI : BcOp::SubI;
+            if ( post ) {
+                int32_t res = target(dst);
+                emit(BcOp::Move, op1->at, res, var);
+                emit(op, op1->at, var, var, constInt(1));
+                return res;
+            } else {
+                emit(op, op1->at, var, var, constInt(1));
+                if ( dst>=0 ) emit(BcOp::Move, op1->at, dst, var);
+                return dst>=0 ? dst : var;
+            }
+        }
+        BcOp op;
+        if ( name=="-" && kind==BcKind::i ) op = BcOp::NegI;
+        else if ( name=="-" && kind==BcKind::f ) op = BcOp::NegF;
+        else if ( name=="~" && kind==BcKind::i ) op = BcOp::NotI;
+        else if ( name=="!" && kind==BcKind::b ) op = BcOp::NotB;
+        else if ( name=="+" && kind!=BcKind::b ) return expr(op1->subexpr, dst);
+        else return fail();
+        int32_t src = expr(op1->subexpr);
+        if ( failed ) return 0;
+        int32_t res = target(dst);
+        emit(op, op1->at, res, src);
+        return res;
+    }
+
+    int32_t BytecodeCompiler::exprOp2 ( ExprOp2 * op2, int32_t dst ) {
+        if ( !op2->func || !op2->func->builtIn ) return fail();
+        auto kind = bytecodeValueKind(op2->left->type);
+        if ( kind!=bytecodeValueKind(op2->right->type) ) return fail();
+        const auto & name = op2->func->name;
+        if ( name=="&&" || name=="||" ) {
+            // short circuit, goes through a temporary the same way ?: does
+            int32_t res = allocReg();
+            vector<int32_t> onFalse, toEnd;
+            branch(op2, false, onFalse);
+            emit(BcOp::Move, op2->at, res, constInt(1));
+            toEnd.push_back(emit(BcOp::Jump, op2->at, 0));
+            patch(onFalse, here());
+            emit(BcOp::Move, op2->at, res, constInt(0));
+            patch(toEnd, here());
+            if ( dst>=0 ) emit(BcOp::Move, op2->at, dst, res);
+            return dst>=0 ? dst : res;
+        }
+        static const struct { const char * name; BcOp opI; BcOp opF; bool isBool; } ops[] = {
+            { "+",  BcOp::AddI, BcOp::AddF, false },
+            { "-",  BcOp::SubI, BcOp::SubF, false },
+            { "*",  BcOp::MulI, BcOp::MulF, false },
+            { "/",  BcOp::DivI, BcOp::DivF, false },
+            { "%",  BcOp::ModI, BcOp::ModF, false },
+            { "&",  BcOp::AndI, BcOp::Total, false },
+            { "|",  BcOp::OrI,  BcOp::Total, false },
+            { "^",  BcOp::XorI, BcOp::Total, false },
+            { "<<", BcOp::ShlI, BcOp::Total, false },
+            { ">>", BcOp::ShrI, BcOp::Total, false },
+            { "==", BcOp::EqI,  BcOp::EqF,  true },
+            { "!=", BcOp::NeI,  BcOp::NeF,  true },
+            { "^^", BcOp::NeI,  BcOp::Total, true },
+            { "<",  BcOp::LtI,  BcOp::LtF,  false },
+            { "<=", BcOp::LeI,  BcOp::LeF,  false },
+            { ">",  BcOp::GtI,  BcOp::GtF,  false },
+            { ">=", BcOp::GeI,  BcOp::GeF,  false },
+        };
+        bool isSet = name.size()>=2 && name.back()=='=' && name!="==" && name!="!=" && name!="<=" && name!=">=";
+        string opName = isSet ? name.substr(0, name.size()-1) : name;
+        BcOp op = BcOp::Total;
+        for ( const auto & o : ops ) {
+            if ( opName!=o.name ) continue;
+            if ( kind==BcKind::i ) op = o.opI;
+            else if ( kind==BcKind::f ) op = o.opF;
+            else if ( kind==BcKind::b && o.isBool ) op = o.opI;
+            break;
+        }
+        if ( op==BcOp::Total ) return fail();
+        if ( isSet ) {
+            int32_t var = variable(op2->left);
+            int32_t src = expr(op2->right);
+            if ( failed ) return 0;
+            emit(op, op2->at, var, var, src);
+            return var;
+        }
+        int32_t l = expr(op2->left);
+        int32_t r = expr(op2->right);
+        if ( failed ) return 0;
+        int32_t res = target(dst);
+        emit(op, op2->at, res, l, r);
+        return res;
+    }
+
+    int32_t BytecodeCompiler::exprCall ( ExprCall * call, int32_t dst ) {
+        auto fn = call->func;
+        if ( !fn ) return fail();
+        if ( fn->builtIn && call->arguments.size()==1 ) {
+            // conversions
+            auto argKind = bytecodeValueKind(call->arguments[0]->type);
+            auto resKind = bytecodeKind(fn->result);
+            if ( fn->name=="float" && resKind==BcKind::f && (argKind==BcKind::i || argKind==BcKind::f) ) {
+                if ( argKind==BcKind::f ) return expr(call->arguments[0], dst);
+                int32_t src = expr(call->arguments[0]);
+                if ( failed ) return 0;
+                int32_t res = target(dst);
+                emit(BcOp::IntToFloat, call->at, res, src);
+                return res;
+            } else if ( fn->name=="int" && resKind==BcKind::i && (argKind==BcKind::i || argKind==BcKind::f) ) {
+                if ( argKind==BcKind::i ) return expr(call->arguments[0], dst);
+                int32_t src = expr(call->arguments[0]);
+                if ( failed ) return 0;
+                int32_t res = target(dst);
+                emit(BcOp::FloatToInt, call->at, res, src);
+                return res;
+            }
+            return fail();
+        }
+        if ( !isBytecodeCallable(fn) ) return fail();
+        // arguments go to consecutive registers
+        int32_t first = regTop;
+        for ( size_t i=0, is=call->arguments.size(); i!=is; ++i ) allocReg();
+        for ( size_t i=0, is=call->arguments.size(); i!=is; ++i ) {
+            expr(call->arguments[i], first + int32_t(i));
+        }
+        if ( failed ) return 0;
+        int32_t res = fn->result->isVoid() ? -1 : target(dst);
+        emit(BcOp::Call, call->at, res, fn->index, first);
+        return res;
+    }
+
+    void BytecodeCompiler::branch ( Expression * cond, bool jumpIf, vector<int32_t> & jumps ) {
+        if ( failed ) return;
+        if ( cond->rtti_isOp1() ) {
+            auto op1 = static_cast<ExprOp1 *>(cond);
+            if ( op1->func && op1->func->builtIn && op1->func->name=="!" ) {
+                branch(op1->subexpr, !jumpIf, jumps);
+                return;
+            }
+        } else if ( cond->rtti_isOp2() ) {
+            auto op2 = static_cast<ExprOp2 *>(cond);
+            if ( op2->func && op2->func->builtIn ) {
+                const auto & name = op2->func->name;
+                if ( (name=="&&" && !jumpIf) || (name=="||" && jumpIf) ) {
+                    branch(op2->left, jumpIf, jumps);
+                    branch(op2->right, jumpIf, jumps);
+                    return;
+                } else if ( name=="&&" || name=="||" ) {
+                    vector<int32_t> skip;
+                    branch(op2->left, !jumpIf, skip);
+                    branch(op2->right, jumpIf, jumps);
+                    patch(skip, here());
+                    return;
+                }
+                // integer compare and jump. inverting the condition is exact for integers only
+                if ( bytecodeValueKind(op2->left->type)==BcKind::i && bytecodeValueKind(op2->right->type)==BcKind::i ) {
+                    static const struct { const char * name; BcOp op; BcOp notOp; } cmps[] = {
+                        { "==", BcOp::JumpEqI, BcOp::JumpNeI },
+                        { "!=", BcOp::JumpNeI, BcOp::JumpEqI },
+                        { "<",  BcOp::JumpLtI, BcOp::JumpGeI },
+                        { "<=", BcOp::JumpLeI, BcOp::JumpGtI },
+                        { ">",  BcOp::JumpGtI, BcOp::JumpLeI },
+                        { ">=", BcOp::JumpGeI, BcOp::JumpLtI },
+                    };
+                    for ( const auto & c : cmps ) {
+                        if ( name!=c.name ) continue;
+                        int32_t l = expr(op2->left);
+                        int32_t r = expr(op2->right);
+                        if ( failed ) return;
+                        jumps.push_back(emit(jumpIf ? c.op : c.notOp, cond->at, l, r));
+                        return;
+                    }
+                }
+            }
+        }
+        int32_t value = expr(cond);
+        if ( failed ) return;
+        jumps.push_back(emit(jumpIf ? BcOp::JumpIfTrue : BcOp::JumpIfFalse, cond->at, value));
+    }
+
+    void BytecodeCompiler::forLoop ( ExprFor * efor ) {
+        if ( efor->sources.size()!=1 || efor->iteratorVariables.size()!=1 ) { fail(); return; }
+        auto src = efor->sources[0];
+        auto ivar = efor->iteratorVariables[0];
+        if ( !src->type || src->type->baseType!=Type::tRange || src->type->dim.size() ) { fail(); return; }
+        if ( bytecodeKind(ivar->type)!=BcKind::i ) { fail(); return; }
+        // range is evaluated once, before the loop
+        int32_t iter = allocReg();
+        int32_t last = allocReg();
+        if ( src->rtti_isConstant() ) {
+            auto r = cast<range>::to(static_cast<ExprConst *>(src)->value);
+            emit(BcOp::Move, src->at, iter, constInt(r.from));
+            emit(BcOp::Move, src->at, last, constInt(r.to));
+        } else if ( src->rtti_isCall() ) {
+            auto call = static_cast<ExprCall *>(src);
+            if ( !call->func || !call->func->builtIn || (call->func->name!="range" && call->func->name!="interval") ) { fail(); return; }
+            if ( call->arguments.size()==1 && call->func->name=="range" ) {
+                expr(call->arguments[0], last);
+                emit(BcOp::Move, src->at, iter, constInt(0));
+            } else if ( call->arguments.size()==2 ) {
+                expr(call->arguments[0], iter);
+                expr(call->arguments[1], last);
+            } else {
+                fail();
+                return;
+            }
+        } else {
+            fail();
+            return;
+        }
+        if ( failed ) return;
+        vars[ivar] = iter;
+        vector<int32_t> exit;
+        exit.push_back(emit(BcOp::JumpGeI, efor->at, iter, last));
+        int32_t body = here();
+        loops.emplace_back();
+        statement(efor->body);
+        auto loop = das::move(loops.back());
+        loops.pop_back();
+        patch(loop.continues, here());
+        emit(BcOp::LoopI, efor->at, iter, last, body);
+        patch(exit, here());
+        patch(loop.breaks, here());
+    }
+
+    void BytecodeCompiler::block ( ExprBlock * blk ) {
+        if ( blk->isClosure || !blk->finalList.empty() ) { fail(); return; }
+        for ( auto & ex : blk->list ) {
+            if ( failed ) return;
+            int32_t top = regTop;
+            statement(ex);
+            // temporaries die with the statement, variables live until the end of the block
+            if ( !ex->rtti_isLet() ) regTop = top;
+        }
+    }
+
+    void BytecodeCompiler::statement ( Expression * ex ) {
+        if ( failed || !ex ) return;
+        if ( ex->rtti_isBlock() ) {
+            block(static_cast<ExprBlock *>(ex));
+        } else if ( ex->rtti_isLet() ) {
+            auto let = static_cast<ExprLet *>(ex);
+            for ( auto & var : let->variables ) {
+                if ( bytecodeKind(var->type)==BcKind::none ) { fail(); return; }
+                int32_t reg = allocReg();
+                if ( var->init ) {
+                    expr(var->init, reg);
+                } else {
+                    emit(BcOp::Move, let->at, reg, constInt(0));
+                }
+                vars[var] = reg;    // after the initializer, which may refer to the shadowed variable
+            }
+        } else if ( ex->rtti_isCopy() ) {
+            auto copy = static_cast<ExprCopy *>(ex);
+            int32_t var = variable(copy->left);
+            if ( failed ) return;
+            expr(copy->right, var);
+        } else if ( ex->rtti_isIfThenElse() ) {
+            auto ite = static_cast<ExprIfThenElse *>(ex);
+            vector<int32_t> onFalse;
+            branch(ite->cond, false, onFalse);
+            statement(ite->if_true);
+            if ( ite->if_false ) {
+                int32_t toEnd = emit(BcOp::Jump, ite->at, 0);
+                patch(onFalse, here());
+                statement(ite->if_false);
+                code[toEnd].c = here();
+            } else {
+                patch(onFalse, here());
+            }
+        } else if ( ex->rtti_isWhile() ) {
+            // jump to the condition, which is at the bottom of the loop
+            auto wh = static_cast<ExprWhile *>(ex);
+            int32_t toCond = emit(BcOp::Jump, wh->at, 0);
+            int32_t body = here();
+            loops.emplace_back();
+            statement(wh->body);
+            auto loop = das::move(loops.back());
+            loops.pop_back();
+            int32_t cond = here();
+            code[toCond].c = cond;
+            patch(loop.continues, cond);
+            vector<int32_t> onTrue;
+            branch(wh->cond, true, onTrue);
+            patch(onTrue, body);
+            patch(loop.breaks, here());
+        } else if ( ex->rtti_isFor() ) {
+            forLoop(static_cast<ExprFor *>(ex));
+        } else if ( ex->rtti_isBreak() ) {
+            if ( loops.empty() ) { fail(); return; }
+            loops.back().breaks.push_back(emit(BcOp::Jump, ex->at, 0));
+        } else if ( ex->rtti_isContinue() ) {
+            if ( loops.empty() ) { fail(); return; }
+            loops.back().continues.push_back(emit(BcOp::Jump, ex->at, 0));
+        } else if ( ex->rtti_isReturn() ) {
+            auto ret = static_cast<ExprReturn *>(ex);
+            if ( ret->returnInBlock ) { fail(); return; }
+            if ( ret->subexpr ) {
+                int32_t value = expr(ret->subexpr);
+                if ( failed ) return;
+                emit(BcOp::Return, ret->at, value);
+            } else {
+                emit(BcOp::ReturnVoid, ret->at, 0);
+            }
+        } else if ( ex->rtti_isCall() ) {
+            auto call = static_cast<ExprCall *>(ex);
+            if ( call->func && call->func->result->isVoid() ) {
+                if ( !isBytecodeCallable(call->func) ) { fail(); return; }
+                int32_t first = regTop;
+                for ( size_t i=0, is=call->arguments.size(); i!=is; ++i ) allocReg();
+                for ( size_t i=0, is=call->arguments.size(); i!=is; ++i ) {
+                    expr(call->arguments[i], first + int32_t(i));
+                }
+                if ( failed ) return;
+                emit(BcOp::Call, call->at, -1, call->func->index, first);
+            } else {
+                expr(ex);
+            }
+        } else if ( ex->rtti_isOp1() ) {
+            // ++ and -- as statements
+            exprOp1(static_cast<ExprOp1 *>(ex), -1);
+        } else if ( ex->rtti_isOp2() ) {
+            // += and friends as statements
+            exprOp2(static_cast<ExprOp2 *>(ex), -1);
+        } else {
+            expr(ex);
+        }
+    }
+
+    void BytecodeCompiler::finalize() {
+        // constants go after all the other registers
+        auto fix = [&]( int32_t & reg ) {
+            if ( reg<0 ) reg = regMax + (-reg - 1);
+        };
+        for ( auto & ins : code ) {
+            switch ( ins.op ) {
+            case BcOp::Jump:
+                break;
+            case BcOp::JumpIfTrue:
+            case BcOp::JumpIfFalse:
+            case BcOp::Return:
+                fix(ins.a);
+                break;
+            case BcOp::JumpEqI: case BcOp::JumpNeI: case BcOp::JumpLtI:
+            case BcOp::JumpLeI: case BcOp::JumpGtI: case BcOp::JumpGeI:
+            case BcOp::LoopI:
+                fix(ins.a);
+                fix(ins.b);
+                break;
+            case BcOp::Call:
+            case BcOp::ReturnVoid:
+                break;
+            default:
+                fix(ins.b);
+                fix(ins.c);
+                break;
+            }
+        }
+    }
+
+    bool BytecodeCompiler::compile() {
+        if ( !func->body || !func->body->rtti_isBlock() ) return false;
+        if ( func->generator || func->isClassMethod || !isBytecodeCallable(func) ) return false;
+        for ( auto & arg : func->arguments ) {
+            vars[arg] = allocReg();
+        }
+        nArguments = uint32_t(func->arguments.size());
+        block(static_cast<ExprBlock *>(func->body));
+        if ( failed ) return false;
+        // falling off the end of the function
+        if ( func->result->isVoid() ) {
+            emit(BcOp::ReturnVoid, func->body->at, 0);
+        } else {
+            emit(BcOp::Return, func->body->at, constInt(0));
+        }
+        finalize();
+        return true;
+    }
+
+    void Program::lowerToBytecode ( Context & context, TextWriter & logs ) {
+        bool logIt = options.getBoolOption("log_bytecode", false);
+        int totalLowered = 0;
+        for ( auto & pm : library.modules ) {
+            pm->functions.foreach([&](auto pfun){
+                if ( pfun->index<0 || !pfun->used || pfun->isTemplate || pfun->builtIn ) return;
+                auto & gfun = context.functions[pfun->index];
+                if ( !gfun.code || gfun.aot || gfun.jit || gfun.fastcall || gfun.pinvoke ) return;
+                BytecodeCompiler bc(pfun);
+                if ( !bc.compile() ) return;
+                uint32_t nRegs = uint32_t(bc.regMax) + uint32_t(bc.constants.size());
+                auto node = context.code->makeNode<SimNode_Bytecode>(gfun.code->debugInfo);
+                node->saved_code = gfun.code;
+                node->nArguments = bc.nArguments;
+                node->firstConstant = uint32_t(bc.regMax);
+                node->nConstants = uint32_t(bc.constants.size());
+                node->nInstructions = uint32_t(bc.code.size());
+                node->code = (BcInstr *) context.code->allocate(uint32_t(bc.code.size() * sizeof(BcInstr)));
+                memcpy(node->code, bc.code.data(), bc.code.size() * sizeof(BcInstr));
+                node->codeAt = (LineInfo *) context.code->allocate(uint32_t(bc.codeAt.size() * sizeof(LineInfo)));
+                for ( size_t i=0, is=bc.codeAt.size(); i!=is; ++i ) {
+                    new (node->codeAt + i) LineInfo(bc.codeAt[i]);
+                }
+                if ( node->nConstants ) {
+                    node->constants = (BcReg *) context.code->allocate(uint32_t(bc.constants.size() * sizeof(BcReg)));
+                    memcpy(node->constants, bc.constants.data(), bc.constants.size() * sizeof(BcReg));
+                }
+                // register file lives in the frame, right after the prologue
+                uint32_t frameSize = (uint32_t(sizeof(Prologue)) + nRegs * uint32_t(sizeof(BcReg)) + 15) & ~15u;
+                gfun.stackSize = das::max(gfun.stackSize, frameSize);
+                gfun.code = node;
+                totalLowered ++;
+                if ( logIt ) {
+                    logs << "// bytecode " << gfun.mangledName << ", " << nRegs << " registers\n";
+                    for ( size_t i=0, is=bc.code.size(); i!=is; ++i ) {
+                        auto & ins = bc.code[i];
+                        logs << "    " << i << ": " << uint32_t(ins.op) << " " << ins.a << " " << ins.b << " " << ins.c << "\n";
+                    }
+                }
+            });
+        }
+        if ( logIt ) {
+            logs << "// " << totalLowered << " functions lowered to bytecode\n";
+        }
+    }
+}
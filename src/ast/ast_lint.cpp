@@ -1071,6 +1071,8 @@ namespace das {
     // aot
         "no_aot",                       Type::tBool,
         "aot_prologue",                 Type::tBool,
+    // profile guided optimization
+        "pgo_profile",                  Type::tString,
     // logging
         "log",                          Type::tBool,
         "log_optimization_passes",      Type::tBool,
@@ -1084,6 +1086,8 @@ namespace das {
         "log_mem",                      Type::tBool,
         "log_debug_mem",                Type::tBool,
         "log_aot",                      Type::tBool,
+        "log_bytecode",                 Type::tBool,
+        "log_pgo",                      Type::tBool,
         "log_infer_passes",             Type::tBool,
         "log_require",                  Type::tBool,
         "log_generics",                 Type::tBool,
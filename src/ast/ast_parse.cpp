@@ -851,6 +851,8 @@ namespace das {
                     program->allocateStack(logs,true,true);
                 if (!program->failed())
                     program->finalizeAnnotations();
+                if (!program->failed())
+                    program->applyPgoProfile(logs);
                 if (!program->failed())
                     program->updateSemanticHash();
                 if ( policies.macro_context_collect ) libGroup.collectMacroContexts();
@@ -1380,4 +1382,176 @@ namespace das {
             return res;
         }
     }
+
+    // compiled program cache
+    //  file is a fixed header, followed by the serialized payload
+    //  payload is the list of every source file the program was built from with the hash of its content,
+    //  the list of builtin modules it links against with their cumulative hash, and then the program itself
+
+    struct ProgramCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t policiesHash;
+        uint64_t payloadSize;
+        uint64_t payloadHash;
+    };
+
+    static constexpr uint32_t programCacheMagic = 0x43534144;  // DASC
+
+    static uint64_t hashSourceFile ( const FileAccessPtr & access, const string & fileName ) {
+        auto fi = access->getFileInfo(fileName);
+        if ( !fi ) return 0;
+        const char * src = nullptr;
+        uint32_t len = 0;
+        fi->getSourceAndLength(src, len);
+        return src ? hash_block64((const uint8_t *)src, len) : 0;
+    }
+
+    static uint64_t hashPolicies ( CodeOfPolicies & policies ) {
+        SerializationStorageVector storage;
+        AstSerializer ser(&storage, true);
+        ser << policies;
+        return hash_block64(storage.buffer.data(), storage.buffer.size());
+    }
+
+#if !defined(DAS_NO_FILEIO)
+    static ProgramPtr loadCachedProgram ( const string & cacheFileName, const FileAccessPtr & access,
+            ModuleGroup & libGroup, uint64_t policiesHash ) {
+        FILE * f = fopen(cacheFileName.c_str(), "rb");
+        if ( !f ) return nullptr;
+        SerializationStorageVector storage;
+        AstSerializer ser(&storage, false);
+        ProgramCacheHeader header;
+        bool ok = fread(&header, sizeof(header), 1, f)==1
+            && header.magic==programCacheMagic
+            && header.version==ser.getVersion()
+            && header.policiesHash==policiesHash;
+        if ( ok ) {
+            storage.buffer.resize(header.payloadSize);
+            ok = fread(storage.buffer.data(), 1, header.payloadSize, f)==header.payloadSize;
+        }
+        fclose(f);
+        // partially written or damaged file
+        if ( !ok || hash_block64(storage.buffer.data(), storage.buffer.size())!=header.payloadHash ) {
+            return nullptr;
+        }
+        uint64_t count = 0;
+        ser << count;
+        for ( uint64_t i=0; i!=count; ++i ) {
+            string fileName;
+            uint64_t hash = 0;
+            ser << fileName << hash;
+            if ( hashSourceFile(access, fileName)!=hash ) return nullptr;
+        }
+        ser << count;
+        for ( uint64_t i=0; i!=count; ++i ) {
+            string name;
+            uint64_t hash = 0;
+            ser << name << hash;
+            auto mod = Module::require(name);
+            if ( !mod || mod->cumulativeHash!=hash ) return nullptr;
+        }
+        auto & bound = *daScriptEnvironment::getBound();
+        auto savedProgram = bound.g_Program;
+        auto program = make_smart<Program>();
+        {
+            gc_guard cache_gc_scope;
+            program->serialize(ser);
+        }
+        ser.moduleLibrary = nullptr;
+        bound.g_Program = savedProgram;
+        if ( program->failToCompile ) {
+            (void)program->thisModule.release();
+            program->library.reset();
+            return nullptr;
+        }
+        // the group owns dependencies, same as after compileDaScript
+        program->thisModuleGroup = &libGroup;
+        program->library.foreach([&](Module * pm) -> bool {
+            if ( !pm->builtIn && pm!=program->thisModule.get() && !libGroup.findModule(pm->name) ) {
+                libGroup.addModule(pm);
+            }
+            return true;
+        }, "*");
+        return program;
+    }
+
+    static void saveCachedProgram ( const string & cacheFileName, const ProgramPtr & program,
+            const FileAccessPtr & access, uint64_t policiesHash, TextWriter & logs ) {
+        vector<string> sources = access->getFileNames();
+        vector<Module *> builtins;
+        program->library.foreach([&](Module * pm) -> bool {
+            if ( pm->builtIn && !pm->promoted ) {
+                builtins.push_back(pm);
+            } else if ( !pm->fileName.empty() ) {
+                sources.push_back(pm->fileName);
+            }
+            return true;
+        }, "*");
+        sort(sources.begin(), sources.end());
+        sources.erase(unique(sources.begin(), sources.end()), sources.end());
+        SerializationStorageVector storage;
+        ProgramCacheHeader header;
+        {
+            AstSerializer ser(&storage, true);
+            uint64_t count = sources.size();
+            ser << count;
+            for ( auto & fileName : sources ) {
+                uint64_t hash = hashSourceFile(access, fileName);
+                ser << fileName << hash;
+            }
+            count = builtins.size();
+            ser << count;
+            for ( auto mod : builtins ) {
+                ser << mod->name << mod->cumulativeHash;
+            }
+            program->serialize(ser);
+            ser.moduleLibrary = nullptr;
+            header.magic = programCacheMagic;
+            header.version = ser.getVersion();
+        }
+        header.policiesHash = policiesHash;
+        header.payloadSize = storage.buffer.size();
+        header.payloadHash = hash_block64(storage.buffer.data(), storage.buffer.size());
+        // write next to the cache and rename, so that concurrent readers never see a partial file
+        auto tempFileName = cacheFileName + ".tmp";
+        FILE * f = fopen(tempFileName.c_str(), "wb");
+        if ( !f ) {
+            logs << "program cache: can't write '" << cacheFileName << "'\n";
+            return;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, f)==1
+            && fwrite(storage.buffer.data(), 1, storage.buffer.size(), f)==storage.buffer.size();
+        ok = (fclose(f)==0) && ok;
+        remove(cacheFileName.c_str());
+        if ( !ok || rename(tempFileName.c_str(), cacheFileName.c_str())!=0 ) {
+            remove(tempFileName.c_str());
+            logs << "program cache: can't write '" << cacheFileName << "'\n";
+        }
+    }
+#endif
+
+    ProgramPtr compileDaScriptCached ( const string & fileName,
+                                       const string & cacheFileName,
+                                       const FileAccessPtr & access,
+                                       TextWriter & logs,
+                                       ModuleGroup & libGroup,
+                                       CodeOfPolicies policies,
+                                       bool * cacheHit ) {
+        if ( cacheHit ) *cacheHit = false;
+#if !defined(DAS_NO_FILEIO)
+        auto policiesHash = hashPolicies(policies);
+        if ( auto program = loadCachedProgram(cacheFileName, access, libGroup, policiesHash) ) {
+            if ( cacheHit ) *cacheHit = true;
+            return program;
+        }
+        auto program = compileDaScript(fileName, access, logs, libGroup, policies);
+        if ( program && !program->failed() ) {
+            saveCachedProgram(cacheFileName, program, access, policiesHash, logs);
+        }
+        return program;
+#else
+        return compileDaScript(fileName, access, logs, libGroup, policies);
+#endif
+    }
 }
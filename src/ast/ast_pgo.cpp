@@ -0,0 +1,104 @@
+#include "daScript/misc/platform.h"
+
+#include "daScript/ast/ast.h"
+#include "daScript/ast/ast_expressions.h"
+#include "daScript/ast/ast_visitor.h"
+
+namespace das {
+
+    // Profile guided optimization.
+    //  Profile is a text file, which daslib/pgo records through statement instrumentation.
+    //  There is one line per statement:
+    //      <hits> <line> <column> <file name>
+    //  Statements which were instrumented but never ran are there too, with 0 hits.
+    //  Hits of an 'if' statement, compared to hits of the first statement of its 'if' block,
+    //  tell how often the branch is taken. Strongly biased branches are marked likely or unlikely,
+    //  and AOT emits DAS_LIKELY / DAS_UNLIKELY for them.
+
+    typedef das_hash_map<string,uint64_t> PgoProfile;
+
+    static string pgoKey ( const string & fileName, uint32_t line, uint32_t column ) {
+        return to_string(line) + " " + to_string(column) + " " + fileName;
+    }
+
+    static bool loadPgoProfile ( const string & fileName, PgoProfile & profile ) {
+        FILE * f = fopen(fileName.c_str(), "rb");
+        if ( !f ) return false;
+        char buf[4096];
+        while ( fgets(buf, sizeof(buf), f) ) {
+            unsigned long long hits = 0;
+            unsigned int line = 0, column = 0;
+            int pos = 0;
+            if ( sscanf(buf, "%llu %u %u %n", &hits, &line, &column, &pos)!=3 || !buf[pos] ) continue;
+            string name(buf + pos);
+            while ( !name.empty() && (name.back()=='\n' || name.back()=='\r') ) name.pop_back();
+            profile[pgoKey(name, line, column)] += hits;
+        }
+        fclose(f);
+        return true;
+    }
+
+    class PgoBranchHints : public Visitor {
+    public:
+        PgoBranchHints ( const PgoProfile & p, TextWriter * l ) : profile(p), logs(l) {}
+        int32_t total = 0;
+    protected:
+        // fewer hits than this say nothing about the branch
+        enum { minHits = 32 };
+        const PgoProfile & profile;
+        TextWriter * logs = nullptr;
+    protected:
+        bool getHits ( const Expression * expr, uint64_t & hits ) const {
+            if ( !expr || !expr->at.fileInfo ) return false;
+            auto it = profile.find(pgoKey(expr->at.fileInfo->name, expr->at.line, expr->at.column));
+            if ( it==profile.end() ) return false;
+            hits = it->second;
+            return true;
+        }
+        static const Expression * firstStatement ( const Expression * expr ) {
+            if ( expr && expr->rtti_isBlock() ) {
+                auto blk = static_cast<const ExprBlock *>(expr);
+                return blk->list.empty() ? nullptr : blk->list.front();
+            }
+            return expr;
+        }
+        virtual void preVisit ( ExprIfThenElse * expr ) override {
+            Visitor::preVisit(expr);
+            if ( expr->isStatic ) return;
+            uint64_t taken = 0, notTaken = 0, hits = 0;
+            if ( !getHits(firstStatement(expr->if_true), taken) ) return;
+            if ( !getHits(expr, hits) ) {
+                // 'elif' is not a statement of a block, so it is not counted. both branches are
+                if ( !getHits(firstStatement(expr->if_false), notTaken) ) return;
+                hits = taken + notTaken;
+            }
+            if ( hits < minHits || taken > hits ) return;
+            expr->isLikely = taken * 10 >= hits * 9;
+            expr->isUnlikely = taken * 10 <= hits;
+            if ( expr->isLikely || expr->isUnlikely ) {
+                total ++;
+                if ( logs ) {
+                    *logs << expr->at.describe() << ": " << (expr->isLikely ? "likely" : "unlikely")
+                        << ", " << taken << " of " << hits << "\n";
+                }
+            }
+        }
+    };
+
+    void Program::applyPgoProfile ( TextWriter & logs ) {
+        auto arg = options.find("pgo_profile", Type::tString);
+        if ( !arg || arg->sValue.empty() ) return;
+        // profile is only a hint. missing or stale profile never fails the compilation
+        PgoProfile profile;
+        if ( !loadPgoProfile(arg->sValue, profile) ) {
+            logs << "can't read PGO profile " << arg->sValue << "\n";
+            return;
+        }
+        bool logPgo = options.getBoolOption("log_pgo", false);
+        PgoBranchHints hints(profile, logPgo ? &logs : nullptr);
+        visit(hints);
+        if ( logPgo ) {
+            logs << "PGO: " << hints.total << " branch hints from " << arg->sValue << "\n";
+        }
+    }
+}
@@ -1570,6 +1570,15 @@ namespace das
         return expr;
     }
 
+    // string keys are hashed byte by byte. when the key is a constant, it is hashed once, here
+    static SimNode * hashConstKey ( SimNode * node, Expression * key ) {
+        if ( node && key->rtti_isStringConstant() ) {
+            auto text = static_cast<ExprConstString *>(key)->text.c_str();
+            static_cast<SimNode_Table *>(node)->constKeyHash = hash_blockz64((const uint8_t *)text);
+        }
+        return node;
+    }
+
     ExpressionPtr SimulateVisitor::visit(ExprErase * expr) {
         const auto &at = expr->at;
         auto cont = getE(expr->arguments[0]);
@@ -1584,7 +1593,7 @@ namespace das
                 valueType = valueT->baseType;
                 val = context.code->makeNode<SimNode_CastToWorkhorse>(at, val);
             }
-            setE(expr, context.code->makeValueNode<SimNode_TableErase>(valueType, at, cont, val, valueTypeSize));
+            setE(expr, hashConstKey(context.code->makeValueNode<SimNode_TableErase>(valueType, at, cont, val, valueTypeSize), expr->arguments[1]));
         } else {
             DAS_ASSERTF(0, "we should not even be here. erase can only accept tables. infer type should have failed.");
             context.thisProgram->error("internal compilation error, generating erase for non-table type", "", "", at, CompilationError::internal_table);
@@ -1607,7 +1616,7 @@ namespace das
                 valueType = valueT->baseType;
                 val = context.code->makeNode<SimNode_CastToWorkhorse>(at, val);
             }
-            setE(expr, context.code->makeValueNode<SimNode_TableSetInsert>(valueType, at, cont, val));
+            setE(expr, hashConstKey(context.code->makeValueNode<SimNode_TableSetInsert>(valueType, at, cont, val), expr->arguments[1]));
         } else {
             DAS_ASSERTF(0, "we should not even be here. erase can only accept tables. infer type should have failed.");
             context.thisProgram->error("internal compilation error, generating set insert for non-table type", "", "", at, CompilationError::internal_table);
@@ -1630,7 +1639,7 @@ namespace das
                 valueType = valueT->baseType;
                 val = context.code->makeNode<SimNode_CastToWorkhorse>(at, val);
             }
-            setE(expr, context.code->makeValueNode<SimNode_TableFind>(valueType, at, cont, val, valueTypeSize));
+            setE(expr, hashConstKey(context.code->makeValueNode<SimNode_TableFind>(valueType, at, cont, val, valueTypeSize), expr->arguments[1]));
         } else {
             DAS_ASSERTF(0, "we should not even be here. find can only accept tables. infer type should have failed.");
             context.thisProgram->error("internal compilation error, generating find for non-table type", "", "", at, CompilationError::internal_table);
@@ -1653,7 +1662,7 @@ namespace das
                 valueType = valueT->baseType;
                 val = context.code->makeNode<SimNode_CastToWorkhorse>(at, val);
             }
-            setE(expr, context.code->makeValueNode<SimNode_KeyExists>(valueType, at, cont, val, valueTypeSize));
+            setE(expr, hashConstKey(context.code->makeValueNode<SimNode_KeyExists>(valueType, at, cont, val, valueTypeSize), expr->arguments[1]));
         } else {
             DAS_ASSERTF(0, "we should not even be here. find can only accept tables. infer type should have failed.");
             context.thisProgram->error("internal compilation error, generating find for non-table type", "", "", at, CompilationError::internal_table);
@@ -1974,7 +1983,7 @@ namespace das
                 keyType = keyValueType->baseType;
                 pidx = context.code->makeNode<SimNode_CastToWorkhorse>(at, pidx);
             }
-            auto res = context.code->makeValueNode<SimNode_TableIndex>(keyType, at, prv, pidx, valueTypeSize, 0);
+            auto res = hashConstKey(context.code->makeValueNode<SimNode_TableIndex>(keyType, at, prv, pidx, valueTypeSize, 0), expr->index);
             if ( expr->r2v ) {
                 setE(expr, GetR2V(context, at, expr->type, res));
             } else {
@@ -2012,7 +2021,7 @@ namespace das
                     valueType = valueT->baseType;
                     pidx = context.code->makeNode<SimNode_CastToWorkhorse>(at, pidx);
                 }
-                setE(expr, context.code->makeValueNode<SimNode_SafeTableIndex>(valueType, at, prv, pidx, valueTypeSize, 0));
+                setE(expr, hashConstKey(context.code->makeValueNode<SimNode_SafeTableIndex>(valueType, at, prv, pidx, valueTypeSize, 0), expr->index));
             } else if ( seT->dim.size() ) {
                 uint32_t range = seT->dim[0];
                 uint32_t stride = seT->getStride();
@@ -2059,7 +2068,7 @@ namespace das
                     valueType = valueT->baseType;
                     pidx = context.code->makeNode<SimNode_CastToWorkhorse>(at, pidx);
                 }
-                setE(expr, context.code->makeValueNode<SimNode_SafeTableIndex>(valueType, at, prv, pidx, valueTypeSize, 0));
+                setE(expr, hashConstKey(context.code->makeValueNode<SimNode_SafeTableIndex>(valueType, at, prv, pidx, valueTypeSize, 0), expr->index));
             } else if ( seT->dim.size() ) {
                 uint32_t range = seT->dim[0];
                 uint32_t stride = seT->getStride();
@@ -3579,6 +3588,8 @@ namespace das
         isSimulating = true;
         context.failed = true;
         context.verySafeContext = options.getBoolOption("very_safe_context",policies.very_safe_context);
+        context.incrementalTableResize = options.getBoolOption("incremental_table_resize",policies.incremental_table_resize);
+        context.parallelGcMark = options.getBoolOption("parallel_gc_mark",policies.parallel_gc_mark);
         astTypeInfo.clear();    // this is to be filled via typeinfo(ast_typedecl and such)
         auto disableInit = options.getBoolOption("no_init", policies.no_init);
         context.thisProgram = this;
@@ -3586,7 +3597,11 @@ namespace das
         context.persistent = options.getBoolOption("persistent_heap", policies.persistent_heap);
         context.gcEnabled = options.getBoolOption("gc", false);
         context.debugger = getDebugger();
-        if ( context.persistent ) {
+        context.sizeClassHeap = options.getBoolOption("size_class_heap", policies.size_class_heap);
+        if ( context.persistent && context.sizeClassHeap ) {
+            context.heap = make_unique<SizeClassHeapAllocator>();
+            context.stringHeap = make_unique<PersistentStringAllocator>();
+        } else if ( context.persistent ) {
             context.heap = make_unique<PersistentHeapAllocator>();
             context.stringHeap = make_unique<PersistentStringAllocator>();
         } else {
@@ -3955,6 +3970,10 @@ namespace das
             SimFunction & fn = context.functions[i];
             func->hash = getFunctionHash(func, fn.code, &context);
         }
+        // after the hash, so that AOT sees the same functions
+        if ( !folding && !policies.debugger && !policies.profiler && options.getBoolOption("bytecode",policies.bytecode) ) {
+            lowerToBytecode(context, logs);
+        }
         for (auto pm : library.modules) {
             pm->structures.foreach([&](auto st){
                 for ( auto & ann : st->annotations ) {
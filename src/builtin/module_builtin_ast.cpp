@@ -377,6 +377,7 @@ namespace das {
     void any_table_foreach ( void * _tab, int keyStride, int valueStride, const TBlock<void,void *,void *> & blk, Context * context, LineInfoArg * at ) {
         auto tab = (Table *) _tab;
         if ( !tab->data ) return;
+        if ( tab->resizeData ) table_finish_resize(context, *tab, at);
         char * values = tab->data;
         char * keys = tab->keys;
         for ( uint32_t index=0, indexs=tab->capacity; index!=indexs; index++, keys+=keyStride, values+=valueStride ) {
@@ -253,7 +253,7 @@ namespace das {
     TypeDeclPtr makeExprIfFlags() {
         auto ft = new TypeDecl(Type::tBitfield);
         ft->alias = "IfFlags";
-        ft->argNames = { "isStatic", "doNotFold" };
+        ft->argNames = { "isStatic", "doNotFold", "isLikely", "isUnlikely" };
         return ft;
     }
 
@@ -2478,12 +2478,15 @@ namespace das {
               << value.serialize_main_module
               << value.keep_alive
               << value.very_safe_context
+              << value.incremental_table_resize
+              << value.parallel_gc_mark
               << value.max_infer_passes
               << value.max_call_depth
               << value.verify_infer_types
               << value.stack
               << value.intern_strings
               << value.persistent_heap
+              << value.size_class_heap
               << value.multiple_contexts
               << value.heap_size_hint
               << value.string_heap_size_hint
@@ -2530,6 +2533,7 @@ namespace das {
               << value.fail_on_no_aot
               << value.fail_on_lack_of_aot_export
               << value.no_fast_call
+              << value.bytecode
               << value.scoped_stack_allocator
               << value.force_inscope_pod
               << value.log_inscope_pod
@@ -2669,7 +2673,7 @@ namespace das {
     uint32_t AstSerializer::getVersion () {
         // bumped for ska::flat_hash_map → das::daslang_hash_map switch:
         // iteration order differs, invalidating any cached serialized AST.
-        static constexpr uint32_t currentVersion = 81;
+        static constexpr uint32_t currentVersion = 85;
         return currentVersion;
     }
 
@@ -7,6 +7,7 @@
 #include "daScript/simulate/aot_builtin_debugger.h"
 #include "module_builtin_rtti.h"
 #include "daScript/misc/performance_time.h"
+#include "daScript/simulate/runtime_profile.h"
 #include "daScript/misc/sysos.h"
 
 #include <condition_variable>
@@ -1245,10 +1246,39 @@ namespace debugger {
         ctx.clearInstruments();
     }
 
+    void sampling_profiler_start ( Context & ctx, int32_t intervalUsec ) {
+        ctx.startSampling(uint32_t(das::max(intervalUsec, 1)));
+    }
+
+    void sampling_profiler_stop ( Context & ctx ) {
+        ctx.stopSampling();
+    }
+
+    uint64_t sampling_profiler_samples ( Context & ctx ) {
+        return ctx.sampler ? ctx.sampler->totalSamples() : 0;
+    }
+
+    char * sampling_profiler_report ( Context & ctx, Context * context, LineInfoArg * at ) {
+        TextWriter tw;
+        ctx.reportSamples(tw);
+        return context->allocateString(tw.str(), at);
+    }
+
     bool has_function ( Context & ctx, const char * name ) {
         return ctx.findFunction(name ? name : "") != nullptr;
     }
 
+    int32_t hot_patch_context ( Context & ctx, Context & from ) {
+        shared_ptr<Context> source;
+        if ( from.sharedPtrContext ) {
+            source = from.shared_from_this();
+        } else {
+            from.addRef();
+            source = shared_ptr<Context>(&from, [](Context * pctx) { pctx->delRef(); });
+        }
+        return ctx.hotPatchFrom(source);
+    }
+
     Context * hw_bp_context[DAS_MAX_HW_BREAKPOINTS] = {
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
@@ -1392,6 +1422,19 @@ namespace debugger {
             addExtern<DAS_BIND_FUN(clear_instruments)>(*this, lib,  "clear_instruments",
                 SideEffects::modifyExternal, "clear_instruments")
                     ->arg("context");
+            // sampling profiler
+            addExtern<DAS_BIND_FUN(sampling_profiler_start)>(*this, lib,  "sampling_profiler_start",
+                SideEffects::modifyExternal, "sampling_profiler_start")
+                    ->args({"context","interval_usec"});
+            addExtern<DAS_BIND_FUN(sampling_profiler_stop)>(*this, lib,  "sampling_profiler_stop",
+                SideEffects::modifyExternal, "sampling_profiler_stop")
+                    ->arg("context");
+            addExtern<DAS_BIND_FUN(sampling_profiler_samples)>(*this, lib,  "sampling_profiler_samples",
+                SideEffects::accessExternal, "sampling_profiler_samples")
+                    ->arg("context");
+            addExtern<DAS_BIND_FUN(sampling_profiler_report)>(*this, lib,  "sampling_profiler_report",
+                SideEffects::accessExternal, "sampling_profiler_report")
+                    ->args({"ctx","context","at"});
             // user commands
             addExtern<DAS_BIND_FUN(dapiUserCommand)>(*this, lib,  "debug_agent_command",
                 SideEffects::modifyExternal, "dapiUserCommand")
@@ -1430,6 +1473,10 @@ namespace debugger {
             addExtern<DAS_BIND_FUN(has_function)>(*this, lib,  "has_function",
                 SideEffects::none, "has_function")
                     ->args({"context","function_name"});
+            // hot patch
+            addExtern<DAS_BIND_FUN(hot_patch_context)>(*this, lib,  "hot_patch_context",
+                SideEffects::modifyExternal, "hot_patch_context")
+                    ->args({"context","from"});
             // pinvoke
             addInterop<pinvoke_impl,void,vec4f,const char *>(*this,lib,"invoke_in_context",
                 SideEffects::worstDefault,"pinvoke_impl")->unsafeOperation = true;
@@ -28,7 +28,7 @@ MAKE_TYPE_FACTORY(clock, das::Time)// use MAKE_TYPE_FACTORY out of namespace. So
     /* macro definitions extracted from /usr/include/bits/mman.h */
     #define MAP_SHARED  0x01        /* Share changes.  */
     #define MAP_PRIVATE 0x02        /* Changes are private.  */
-    void* mmap(void* start, size_t length, int prot, int flags, int fd, off_t offset);
+    void* mmap(void* start, size_t length, int prot, int flags, int fd, int64_t offset);
     int munmap(void* start, size_t length);
     static int getchar_wrapper(void) { return getchar(); } // workaround for non-std callconv (fastcall, vectorcall...)
 
@@ -120,6 +120,12 @@ namespace das {
     void builtin_fclose ( const FILE * f, Context * context, LineInfoArg * at ) GENERATE_IO_STUB
     void builtin_fflush ( const FILE * f, Context * context, LineInfoArg * at ) GENERATE_IO_STUB
     void builtin_map_file(const FILE* f, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at) GENERATE_IO_STUB
+    void builtin_map_file_range ( const FILE* f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
+    void builtin_map_file_shared ( const FILE* f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
+    void builtin_map_file_records ( const FILE* f, int32_t delimiter, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
+    void builtin_map_file_records_default ( const FILE* f, int32_t delimiter, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
+    void builtin_map_file_lines ( const FILE* f, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
+    void builtin_map_file_lines_default ( const FILE* f, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) GENERATE_IO_STUB
     int64_t builtin_ftell ( const FILE * f, Context * context, LineInfoArg * at ) GENERATE_IO_STUB
     int64_t builtin_fseek ( const FILE * f, int64_t offset, int32_t mode, Context * context, LineInfoArg * at ) GENERATE_IO_STUB
     char * builtin_fread ( const FILE * f, Context * context, LineInfoArg * at ) GENERATE_IO_STUB
@@ -291,18 +297,178 @@ namespace das {
         return feof(f);
     }
 
+    static bool map_file_size ( FILE * f, int & fd, uint64_t & size ) {
+        fd = fileno(f);
+#if _WIN32
+        struct _stat64 st;
+        if ( _fstat64(fd, &st) ) return false;
+#else
+        struct stat st;
+        if ( fstat(fd, &st) ) return false;
+#endif
+        size = uint64_t(st.st_size);
+        return true;
+    }
+
+    static uint64_t map_granularity () {
+#if _WIN32
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        return si.dwAllocationGranularity;
+#else
+        return uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    static void map_advise ( void * data, size_t length, int32_t advice ) {
+#if _WIN32
+        (void)data; (void)length; (void)advice;     // no madvise equivalent for mapped views
+#else
+        int adv = MADV_NORMAL;
+        switch ( advice ) {
+            case fmap_sequential:   adv = MADV_SEQUENTIAL; break;
+            case fmap_random:       adv = MADV_RANDOM; break;
+            case fmap_willneed:     adv = MADV_WILLNEED; break;
+            case fmap_dontneed:     adv = MADV_DONTNEED; break;
+            default:                break;
+        }
+        madvise(data, length, adv);
+#endif
+    }
+
+    // mapping of [offset, offset+length). offset does not have to be aligned, view starts at the granularity boundary below it
+    struct MappedWindow {
+        void *  base = nullptr;
+        size_t  size = 0;
+        char *  data = nullptr;
+        bool map ( int fd, uint64_t offset, uint64_t length, int prot, int flags ) {
+            uint64_t aligned = offset - offset % map_granularity();
+            size = size_t(length + offset - aligned);
+            base = mmap(nullptr, size, prot, flags, fd, aligned);
+            if ( base==MAP_FAILED ) {
+                base = nullptr;
+                return false;
+            }
+            data = (char *)base + (offset - aligned);
+            return true;
+        }
+        ~MappedWindow() {
+            if ( base ) munmap(base, size);
+        }
+    };
+
     void builtin_map_file(const FILE* f, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at) {
         if ( !f ) context->throw_error_at(at, "can't map NULL file");
-        struct stat st;
-        int fd = fileno((FILE *)f);
-        fstat(fd, &st);
-        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        int fd = 0;
+        uint64_t size = 0;
+        if ( !map_file_size((FILE *)f, fd, size) ) context->throw_error_at(at, "can't stat file to map");
+        if ( size >= 0xffffffff ) context->throw_error_at(at, "can't map %llu bytes at once, use fmap with offset and length", (unsigned long long)size);
+        MappedWindow win;
+        Array arr;
+        if ( size ) {
+            if ( !win.map(fd, 0, size, PROT_READ, MAP_SHARED) ) context->throw_error_at(at, "can't map file");
+        }
+        array_mark_locked(arr, win.data, uint32_t(size));
+        vec4f args[1];
+        args[0] = cast<Array *>::from(&arr);
+        context->invoke(blk, args, nullptr, at);
+    }
+
+    static void map_file_range ( const FILE * f, int64_t offset, int64_t length, int32_t advice, bool writable, const Block & blk, Context * context, LineInfoArg * at ) {
+        if ( !f ) context->throw_error_at(at, "can't map NULL file");
+        if ( offset<0 || length<0 ) context->throw_error_at(at, "can't map negative range, offset=%lld length=%lld", (long long)offset, (long long)length);
+        int fd = 0;
+        uint64_t size = 0;
+        if ( !map_file_size((FILE *)f, fd, size) ) context->throw_error_at(at, "can't stat file to map");
+        if ( uint64_t(offset) > size ) context->throw_error_at(at, "map offset %lld is past the end of file (%llu bytes)", (long long)offset, (unsigned long long)size);
+        uint64_t len = min(uint64_t(length), size - uint64_t(offset));
+        if ( len >= 0xffffffff ) context->throw_error_at(at, "can't map %llu bytes at once, window has to be under 4GB", (unsigned long long)len);
+        MappedWindow win;
         Array arr;
-        array_mark_locked(arr, data, uint32_t(st.st_size));
+        if ( len ) {
+            int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+            if ( !win.map(fd, uint64_t(offset), len, prot, MAP_SHARED) ) {
+                context->throw_error_at(at, writable ? "can't map file for writing, it has to be open with 'r+b'" : "can't map file");
+            }
+            map_advise(win.base, win.size, advice);
+        }
+        array_mark_locked(arr, win.data, uint32_t(len));
         vec4f args[1];
         args[0] = cast<Array *>::from(&arr);
         context->invoke(blk, args, nullptr, at);
-        munmap(data, st.st_size);
+    }
+
+    void builtin_map_file_range ( const FILE* f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_range(f, offset, length, advice, false, blk, context, at);
+    }
+
+    void builtin_map_file_shared ( const FILE* f, int64_t offset, int64_t length, int32_t advice, const TBlock<void, TTemporary<TArray<uint8_t>>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_range(f, offset, length, advice, true, blk, context, at);
+    }
+
+    static constexpr int64_t fmapRecordWindow = 64ll << 20;
+
+    // walks the file in copy-on-write windows. delimiter is temporarily replaced with 0, which makes each record a string
+    // pointing straight into the mapping. record which crosses the window end starts the next window
+    static void map_file_records ( const FILE * f, int32_t delimiter, int64_t window, bool lines, const Block & blk, Context * context, LineInfoArg * at ) {
+        if ( !f ) context->throw_error_at(at, "can't map NULL file");
+        if ( window<=0 ) context->throw_error_at(at, "map window has to be positive, got %lld", (long long)window);
+        int fd = 0;
+        uint64_t size = 0;
+        if ( !map_file_size((FILE *)f, fd, size) ) context->throw_error_at(at, "can't stat file to map");
+        uint64_t winSize = uint64_t(window);
+        uint64_t pos = 0;
+        vec4f args[1];
+        context->invokeEx(blk, args, nullptr, [&](SimNode * code) {
+            auto emit = [&]( char * rec, char * recEnd ) {
+                if ( lines && recEnd>rec && recEnd[-1]=='\r' ) recEnd[-1] = 0;
+                args[0] = cast<const char *>::from(rec);
+                code->eval(*context);
+            };
+            while ( pos < size ) {
+                uint64_t length = min(winSize, size - pos);
+                bool last = pos + length == size;
+                MappedWindow win;
+                if ( !win.map(fd, pos, length, PROT_READ | PROT_WRITE, MAP_PRIVATE) ) context->throw_error_at(at, "can't map file");
+                map_advise(win.base, win.size, fmap_sequential);
+                char * cur = win.data;
+                char * end = win.data + length;
+                while ( cur < end ) {
+                    char * eor = (char *) memchr(cur, delimiter, end - cur);
+                    if ( !eor ) break;
+                    *eor = 0;
+                    emit(cur, eor);
+                    cur = eor + 1;
+                }
+                if ( cur<end && last ) {
+                    // last record without delimiter, there may be no room for the terminator
+                    string tail(cur, end - cur);
+                    emit((char *)tail.c_str(), (char *)tail.c_str() + tail.size());
+                    cur = end;
+                } else if ( cur==win.data ) {
+                    // record is longer than the window
+                    winSize *= 2;
+                    if ( winSize >= 0xffffffff ) context->throw_error_at(at, "record at offset %llu is too long to map", (unsigned long long)pos);
+                }
+                pos += uint64_t(cur - win.data);
+            }
+        }, at);
+    }
+
+    void builtin_map_file_records ( const FILE* f, int32_t delimiter, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_records(f, delimiter, window, false, blk, context, at);
+    }
+
+    void builtin_map_file_records_default ( const FILE* f, int32_t delimiter, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_records(f, delimiter, fmapRecordWindow, false, blk, context, at);
+    }
+
+    void builtin_map_file_lines ( const FILE* f, int64_t window, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_records(f, '\n', window, true, blk, context, at);
+    }
+
+    void builtin_map_file_lines_default ( const FILE* f, const TBlock<void, TTemporary<const char *>>& blk, Context* context, LineInfoArg * at ) {
+        map_file_records(f, '\n', fmapRecordWindow, true, blk, context, at);
     }
 
     int64_t builtin_ftell ( const FILE * f, Context * context, LineInfoArg * at ) {
@@ -1090,9 +1256,23 @@ namespace das {
         Fail,           // error message is displayed and exception is thrown
     };
 
+    // process wide, every environment (i.e. every compiling thread) registers the same modules
+    static mutex g_registered_mutex;
     static vector<tuple<string,string,string>> g_registered_dynamic_modules; // path, cpp_class_name, daslang_name
     static vector<tuple<string,string,string>> g_registered_native_paths;
 
+    static void add_registered ( vector<tuple<string,string,string>> & reg, tuple<string,string,string> && entry ) {
+        lock_guard<mutex> guard(g_registered_mutex);
+        if ( find(reg.begin(), reg.end(), entry) == reg.end() ) {
+            reg.emplace_back(das::move(entry));
+        }
+    }
+
+    static vector<tuple<string,string,string>> get_registered ( const vector<tuple<string,string,string>> & reg ) {
+        lock_guard<mutex> guard(g_registered_mutex);
+        return reg;
+    }
+
     // Returns DLL handle.
     void *register_dynamic_module(const char *path, const char *mod_name, int on_error, Context * context, LineInfoArg * at ) {
         string actualPath(path);
@@ -1140,7 +1320,7 @@ namespace das {
             return nullptr;
         }
         *ModuleKarma += unsigned(intptr_t(mod));
-        g_registered_dynamic_modules.emplace_back(path, mod_name, mod->name);
+        add_registered(g_registered_dynamic_modules, make_tuple(string(path), string(mod_name), mod->name));
         return lib;
     }
     void *register_dynamic_module_silent(const char *path, const char *mod_name, Context * context, LineInfoArg * at ) {
@@ -1163,17 +1343,17 @@ namespace das {
             cur_mod = prev(mod_resolve->end());
         }
         cur_mod->paths.emplace_back(src_path, dst_path);
-        g_registered_native_paths.emplace_back(mod_name, src_path, dst_path);
+        add_registered(g_registered_native_paths, make_tuple(string(mod_name), string(src_path), string(dst_path)));
     }
 
     void for_each_registered_native_path ( const TBlock<void,const char *,const char *,const char *> & block, Context * context, LineInfoArg * at ) {
-        for ( const auto & [mod_name, src_path, dst_path] : g_registered_native_paths ) {
+        for ( const auto & [mod_name, src_path, dst_path] : get_registered(g_registered_native_paths) ) {
             das_invoke<void>::invoke<const char *,const char *,const char *>(context, at, block, mod_name.c_str(), src_path.c_str(), dst_path.c_str());
         }
     }
 
     void for_each_registered_dynamic_module ( const TBlock<void,const char *,const char *,const char *> & block, Context * context, LineInfoArg * at ) {
-        for ( const auto & [path, mod_name, das_name] : g_registered_dynamic_modules ) {
+        for ( const auto & [path, mod_name, das_name] : get_registered(g_registered_dynamic_modules) ) {
             das_invoke<void>::invoke<const char *,const char *,const char *>(context, at, block, path.c_str(), mod_name.c_str(), das_name.c_str());
         }
     }
@@ -1446,6 +1626,12 @@ namespace das {
             addConstant<int32_t>(*this, "seek_set", SEEK_SET);
             addConstant<int32_t>(*this, "seek_cur", SEEK_CUR);
             addConstant<int32_t>(*this, "seek_end", SEEK_END);
+            // fmap access hints
+            addConstant<int32_t>(*this, "fmap_normal", fmap_normal);
+            addConstant<int32_t>(*this, "fmap_sequential", fmap_sequential);
+            addConstant<int32_t>(*this, "fmap_random", fmap_random);
+            addConstant<int32_t>(*this, "fmap_willneed", fmap_willneed);
+            addConstant<int32_t>(*this, "fmap_dontneed", fmap_dontneed);
             // file io
             addExtern<DAS_BIND_FUN(builtin_remove_file)>(*this, lib, "remove",
                 SideEffects::modifyExternal, "builtin_remove_file")
@@ -1486,6 +1672,24 @@ namespace das {
             addExtern<DAS_BIND_FUN(builtin_map_file)>(*this, lib, "fmap",
                 SideEffects::modifyExternal, "builtin_map_file")
                     ->args({"file","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_range)>(*this, lib, "fmap",
+                SideEffects::modifyExternal, "builtin_map_file_range")
+                    ->args({"file","offset","length","advice","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_shared)>(*this, lib, "fmap_shared",
+                SideEffects::modifyExternal, "builtin_map_file_shared")
+                    ->args({"file","offset","length","advice","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_records)>(*this, lib, "fmap_records",
+                SideEffects::modifyExternal, "builtin_map_file_records")
+                    ->args({"file","delimiter","window","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_records_default)>(*this, lib, "fmap_records",
+                SideEffects::modifyExternal, "builtin_map_file_records_default")
+                    ->args({"file","delimiter","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_lines)>(*this, lib, "fmap_lines",
+                SideEffects::modifyExternal, "builtin_map_file_lines")
+                    ->args({"file","window","block","context","line"});
+            addExtern<DAS_BIND_FUN(builtin_map_file_lines_default)>(*this, lib, "fmap_lines",
+                SideEffects::modifyExternal, "builtin_map_file_lines_default")
+                    ->args({"file","block","context","line"});
             addExtern<DAS_BIND_FUN(builtin_fgets)>(*this, lib, "fgets",
                 SideEffects::modifyExternal, "builtin_fgets")
                     ->args({"file","context","line"});
@@ -1685,22 +1889,27 @@ namespace das {
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
-void * mmap (void* start, size_t length, int /*prot*/, int /*flags*/, int fd, off_t offset) {
+void * mmap (void* start, size_t length, int prot, int flags, int fd, int64_t offset) {
     HANDLE hmap;
     void* temp;
-    size_t len;
-    struct stat st;
+    uint64_t len;
+    struct _stat64 st;
     uint64_t o = offset;
     uint32_t l = o & 0xFFFFFFFF;
     uint32_t h = (o >> 32) & 0xFFFFFFFF;
-    fstat(fd, &st);
-    len = (size_t)st.st_size;
-    if ((length + offset) > len)
-        length = len - offset;
-    hmap = CreateFileMapping((HANDLE)_get_osfhandle(fd), 0, PAGE_WRITECOPY, 0, 0, 0);
+    _fstat64(fd, &st);
+    len = (uint64_t)st.st_size;
+    if ((length + o) > len)
+        length = size_t(len - o);
+    DWORD protect = PAGE_READONLY, access = FILE_MAP_READ;
+    if ( prot & PROT_WRITE ) {
+        protect = (flags & MAP_SHARED) ? PAGE_READWRITE : PAGE_WRITECOPY;
+        access = (flags & MAP_SHARED) ? FILE_MAP_WRITE : FILE_MAP_COPY;
+    }
+    hmap = CreateFileMapping((HANDLE)_get_osfhandle(fd), 0, protect, 0, 0, 0);
     if (!hmap)
         return MAP_FAILED;
-    temp = MapViewOfFileEx(hmap, FILE_MAP_COPY, h, l, length, start);
+    temp = MapViewOfFileEx(hmap, access, h, l, length, start);
     if (!CloseHandle(hmap))
         fprintf(stderr, "unable to close file mapping handle\n");
     return temp ? temp : MAP_FAILED;
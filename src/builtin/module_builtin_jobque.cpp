@@ -12,6 +12,7 @@ MAKE_TYPE_FACTORY(JobStatus, JobStatus)
 MAKE_TYPE_FACTORY(Channel, Channel)
 MAKE_TYPE_FACTORY(LockBox, LockBox)
 MAKE_TYPE_FACTORY(Stream, Stream)
+MAKE_TYPE_FACTORY(ContextPool, ContextPool)
 
 MAKE_TYPE_FACTORY(Atomic32, AtomicTT<int32_t>)
 MAKE_TYPE_FACTORY(Atomic64, AtomicTT<int64_t>)
@@ -78,14 +79,248 @@ namespace das {
         }
     }
 
+    static __forceinline void channel_cpu_relax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(_M_ARM64)
+        __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    Channel::Channel ( Context * ctx, int count, uint32_t capacity ) : owner(ctx) {
+        mTrackMagic = TRACK_CHANNEL;
+        mRemaining = count;
+        uint32_t size = 2;
+        while ( size < capacity ) size <<= 1;
+        ring = new ChannelSlot[size];
+        ringMask = size - 1;
+        // slots are allocated (and tracked) once, items are moved in and out of them
+        for ( uint32_t i=0; i!=size; ++i ) {
+            ring[i].seq.store(i, memory_order_relaxed);
+            ring[i].item.fOwner = this;
+            ring[i].item.fOwnerTrackId = mTrackId;
+        }
+    }
+
     Channel::~Channel() {
         lock_guard<mutex> guard(mCompleteMutex);
         pipe = {};
         tail.clear();
+        if ( ring ) {
+            delete [] ring;
+            ring = nullptr;
+        }
         DAS_ASSERT(mRef==0);
     }
 
+    // claims up to count consecutive slots, which are ready for the cursor (free for the producer, full for the consumer)
+    int Channel::ringClaim ( atomic<uint64_t> & cursor, uint64_t lag, int count, uint64_t & at ) {
+        uint64_t pos = cursor.load(memory_order_relaxed);
+        for ( ;; ) {
+            int n = 0;
+            int64_t dif = 0;
+            while ( n < count ) {
+                uint64_t seq = ring[(pos + n) & ringMask].seq.load(memory_order_acquire);
+                dif = int64_t(seq - (pos + n + lag));
+                if ( dif != 0 ) break;
+                n ++;
+            }
+            if ( n == 0 ) {
+                if ( dif < 0 ) return 0;    // full for the producer, empty for the consumer
+                pos = cursor.load(memory_order_relaxed);
+            } else if ( cursor.compare_exchange_weak(pos, pos + n, memory_order_relaxed) ) {
+                at = pos;
+                return n;
+            }
+        }
+    }
+
+    bool Channel::ringHasItems() const {
+        uint64_t pos = ringHead.load(memory_order_relaxed);
+        return int64_t(ring[pos & ringMask].seq.load(memory_order_acquire) - (pos + 1)) >= 0;
+    }
+
+    bool Channel::ringCanPush() const {
+        uint64_t pos = ringTail.load(memory_order_relaxed);
+        return int64_t(ring[pos & ringMask].seq.load(memory_order_acquire) - pos) >= 0;
+    }
+
+    void Channel::ringWake() {
+        atomic_thread_fence(memory_order_seq_cst);
+        if ( ringParked.load(memory_order_relaxed) ) {
+            lock_guard<mutex> guard(mCompleteMutex);
+            mCond.notify_all();
+        }
+    }
+
+    // spin first, then yield, and only then park on the condition variable
+    // parkReady is called under mCompleteMutex, so it can look at mRemaining
+    template <typename SpinTT, typename ParkTT>
+    bool Channel::ringWait ( SpinTT && spinReady, ParkTT && parkReady, uint32_t timeoutMs ) {
+        for ( int i=0; i!=256; ++i ) {
+            if ( spinReady() ) return true;
+            channel_cpu_relax();
+        }
+        for ( int i=0; i!=16; ++i ) {
+            if ( spinReady() ) return true;
+            this_thread::yield();
+        }
+        ringParked.fetch_add(1);
+        atomic_thread_fence(memory_order_seq_cst);
+        bool res;
+        {
+            unique_lock<mutex> uguard(mCompleteMutex);
+            res = mCond.wait_for(uguard, chrono::milliseconds(timeoutMs), parkReady);
+        }
+        ringParked.fetch_sub(1);
+        return res;
+    }
+
+    void Channel::ringWaitForSpace() {
+        ringWait([&]() { return ringCanPush(); }, [&]() { return ringCanPush(); }, mSleepMs);
+    }
+
+    void Channel::ringPush ( void ** data, int count, TypeInfo * ti, Context * pushCtx ) {
+        while ( count ) {
+            uint64_t pos = 0;
+            int n = ringClaim(ringTail, 0, count, pos);
+            if ( !n ) {
+                ringWaitForSpace();
+                continue;
+            }
+            for ( int i=0; i!=n; ++i ) {
+                auto & slot = ring[(pos + i) & ringMask];
+                slot.item.data = data[i];
+                slot.item.type = ti;
+                slot.item.setFrom(pushCtx);
+                slot.seq.store(pos + i + 1, memory_order_release);
+            }
+            data += n;
+            count -= n;
+            ringWake();
+        }
+    }
+
+    void Channel::ringRelease ( uint64_t pos ) {
+        auto & slot = ring[pos & ringMask];
+        slot.item.clear();
+        slot.seq.store(pos + ringMask + 1, memory_order_release);
+    }
+
+    // items are consumed in place, slot is handed back to producers once the block is done with it
+    int Channel::ringTryPop ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        uint64_t pos = 0;
+        int n = ringClaim(ringHead, 1, maxCount, pos);
+        if ( !n ) return 0;
+        struct ReleaseGuard {
+            Channel * ch;
+            uint64_t pos, end;
+            ~ReleaseGuard() {
+                while ( pos != end ) ch->ringRelease(pos++);
+                ch->ringWake();
+            }
+        } guard { this, pos, pos + n };
+        while ( guard.pos != guard.end ) {
+            void * data = ring[guard.pos & ringMask].item.data;
+            das_invoke<void>::invoke<void *>(context, at, blk, data);
+            ringRelease(guard.pos++);
+        }
+        return n;
+    }
+
+    // returns number of items, 0 if channel is depleted or timeout expired. negative timeout waits forever
+    int Channel::ringPop ( int maxCount, int timeoutMs, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        auto t0 = ref_time_ticks();
+        for ( ;; ) {
+            if ( int n = ringTryPop(maxCount, blk, context, at) ) return n;
+            uint32_t waitMs = mSleepMs;
+            if ( timeoutMs >= 0 ) {
+                int left = timeoutMs - int(get_time_usec(t0) / 1000);
+                if ( left <= 0 ) return 0;
+                waitMs = uint32_t(left);
+            }
+            bool depleted = false;
+            ringWait([&]() { return ringHasItems(); }, [&]() {
+                depleted = mRemaining==0;
+                return depleted || ringHasItems();
+            }, waitMs);
+            if ( depleted && !ringHasItems() ) return 0;
+        }
+    }
+
+    void Channel::ringSnapshot ( vector<ChannelItem> & items ) const {
+        uint64_t head = ringHead.load(memory_order_acquire);
+        uint64_t tailPos = ringTail.load(memory_order_acquire);
+        for ( uint64_t pos = head; pos != tailPos; ++pos ) {
+            auto & slot = ring[pos & ringMask];
+            if ( slot.seq.load(memory_order_acquire) != pos + 1 ) continue;
+            ChannelItem it { slot.item.data, slot.item.type, slot.item.from };
+            atomic_thread_fence(memory_order_acquire);
+            if ( slot.seq.load(memory_order_relaxed) != pos + 1 ) continue;    // consumed while we looked
+            items.push_back(it);
+        }
+    }
+
+    void Channel::takeAll ( vector<Feature> & items ) {
+        if ( ring ) {
+            uint64_t pos = 0;
+            while ( int n = ringClaim(ringHead, 1, int(ringMask + 1), pos) ) {
+                for ( int i=0; i!=n; ++i ) {
+                    items.emplace_back(das::move(ring[(pos + i) & ringMask].item));
+                    ringRelease(pos + i);
+                }
+            }
+            ringWake();
+        } else {
+            lock_guard<mutex> guard(mCompleteMutex);
+            for ( auto & f : pipe ) {
+                items.emplace_back(das::move(f));
+            }
+            pipe.clear();
+        }
+    }
+
+    void Channel::pushFeatures ( vector<Feature> & items ) {
+        if ( items.empty() ) return;
+        if ( ring ) {
+            size_t i = 0;
+            while ( i != items.size() ) {
+                uint64_t pos = 0;
+                int n = ringClaim(ringTail, 0, int(items.size() - i), pos);
+                if ( !n ) {
+                    ringWaitForSpace();
+                    continue;
+                }
+                for ( int j=0; j!=n; ++j, ++i ) {
+                    auto & slot = ring[(pos + j) & ringMask];
+                    auto & f = items[i];
+                    slot.item.data = f.data;
+                    slot.item.type = f.type;
+                    slot.item.from = f.from;
+                    slot.item.fromShared = das::move(f.fromShared);
+                    slot.seq.store(pos + j + 1, memory_order_release);
+                }
+                ringWake();
+            }
+        } else {
+            lock_guard<mutex> guard(mCompleteMutex);
+            for ( auto & f : items ) {
+                pipe.emplace_back(das::move(f));
+                pipe.back().fOwner = this;
+                pipe.back().fOwnerTrackId = mTrackId;
+            }
+            mCond.notify_all();
+        }
+        items.clear();
+    }
+
     void Channel::push ( void * data, TypeInfo * ti, Context * context ) {
+        if ( ring ) {
+            ringPush(&data, 1, ti, context!=owner ? context : nullptr);
+            return;
+        }
         lock_guard<mutex> guard(mCompleteMutex);
         pipe.emplace_back(data, ti, context!=owner ? context : nullptr);
         pipe.back().fOwner = this;
@@ -94,8 +329,12 @@ namespace das {
     }
 
     void Channel::pushBatch ( void ** data, int count, TypeInfo * ti, Context * context ) {
-        lock_guard<mutex> guard(mCompleteMutex);
         auto pushCtx = context!=owner ? context : nullptr;
+        if ( ring ) {
+            ringPush(data, count, ti, pushCtx);
+            return;
+        }
+        lock_guard<mutex> guard(mCompleteMutex);
         for ( int i=0; i!=count; ++i ) {
             pipe.emplace_back(data[i], ti, pushCtx);
             pipe.back().fOwner = this;
@@ -105,6 +344,12 @@ namespace das {
     }
 
     void Channel::pop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        if ( ring ) {
+            if ( !ringPop(1, -1, blk, context, at) ) {
+                das_invoke<void>::invoke<void *>(context, at, blk, nullptr);
+            }
+            return;
+        }
         while ( true ) {
             unique_lock<mutex> uguard(mCompleteMutex);
             if ( !mCond.wait_for(uguard, chrono::milliseconds(mSleepMs), [&]() {
@@ -127,6 +372,7 @@ namespace das {
     }
 
     bool Channel::tryPop ( const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        if ( ring ) return ringTryPop(1, blk, context, at) != 0;
         lock_guard<mutex> guard(mCompleteMutex);
         if ( pipe.empty() ) {
             return false;
@@ -138,6 +384,7 @@ namespace das {
     }
 
     bool Channel::popWithTimeout ( int timeoutMs, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        if ( ring ) return ringPop(1, timeoutMs>0 ? timeoutMs : 0, blk, context, at) != 0;
         unique_lock<mutex> uguard(mCompleteMutex);
         if ( !mCond.wait_for(uguard, chrono::milliseconds(timeoutMs), [&]() {
             return !pipe.empty() || mRemaining <= 0;
@@ -153,7 +400,43 @@ namespace das {
         return true;
     }
 
+    int Channel::popBatch ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        if ( ring ) return ringPop(maxCount, -1, blk, context, at);
+        vector<Feature> items;
+        {
+            unique_lock<mutex> uguard(mCompleteMutex);
+            while ( !mCond.wait_for(uguard, chrono::milliseconds(mSleepMs), [&]() {
+                return mRemaining==0 || !pipe.empty();
+            }) ) {}
+            while ( !pipe.empty() && int(items.size()) < maxCount ) {
+                items.emplace_back(das::move(pipe.front()));
+                pipe.pop_front();
+            }
+        }
+        for ( auto & f : items ) {
+            das_invoke<void>::invoke<void *>(context, at, blk, f.data);
+        }
+        return int(items.size());
+    }
+
+    int Channel::tryPopBatch ( int maxCount, const TBlock<void,void *> & blk, Context * context, LineInfoArg * at ) {
+        if ( ring ) return ringTryPop(maxCount, blk, context, at);
+        vector<Feature> items;
+        {
+            lock_guard<mutex> guard(mCompleteMutex);
+            while ( !pipe.empty() && int(items.size()) < maxCount ) {
+                items.emplace_back(das::move(pipe.front()));
+                pipe.pop_front();
+            }
+        }
+        for ( auto & f : items ) {
+            das_invoke<void>::invoke<void *>(context, at, blk, f.data);
+        }
+        return int(items.size());
+    }
+
     bool Channel::isEmpty() const {
+        if ( ring ) return total()==0;
         lock_guard<mutex> guard(mCompleteMutex);
         return pipe.empty();
     }
@@ -164,6 +447,10 @@ namespace das {
     }
 
     int32_t Channel::total() const {
+        if ( ring ) {
+            int64_t head = int64_t(ringHead.load(memory_order_acquire));
+            return int32_t(max(int64_t(ringTail.load(memory_order_acquire)) - head, int64_t(0)));
+        }
         lock_guard<mutex> guard(mCompleteMutex);
         return (int32_t) pipe.size();
     }
@@ -255,6 +542,18 @@ namespace das {
         return ch->popWithTimeout(timeoutMs,blk,context,at);
     }
 
+    int32_t channelPopBatch ( Channel * ch, int32_t maxCount, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !ch ) context->throw_error_at(at, "channelPopBatch: channel is null");
+        if ( maxCount <= 0 ) context->throw_error_at(at, "channelPopBatch: max_count must be positive, got %i", maxCount);
+        return ch->popBatch(maxCount,blk,context,at);
+    }
+
+    int32_t channelTryPopBatch ( Channel * ch, int32_t maxCount, const TBlock<void,void*> & blk, Context * context, LineInfoArg * at ) {
+        if ( !ch ) context->throw_error_at(at, "channelTryPopBatch: channel is null");
+        if ( maxCount <= 0 ) context->throw_error_at(at, "channelTryPopBatch: max_count must be positive, got %i", maxCount);
+        return ch->tryPopBatch(maxCount,blk,context,at);
+    }
+
     int jobAppend ( JobStatus * ch, int size, Context * context, LineInfoArg * at ) {
         if ( !ch ) context->throw_error_at(at, "jobAppend: job is null");
         return ch->append(size);
@@ -278,6 +577,31 @@ namespace das {
         return ch;
     }
 
+    static void verifyChannelCapacity ( int32_t capacity, Context * context, LineInfoArg * at ) {
+        if ( capacity <= 0 || capacity > (1<<24) ) {
+            context->throw_error_at(at, "bounded channel capacity must be in 1..%i range, got %i", 1<<24, capacity);
+        }
+    }
+
+    void withBoundedChannel ( int32_t capacity, const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * at ) {
+        withBoundedChannelEx(capacity, 0, blk, context, at);
+    }
+
+    void withBoundedChannelEx ( int32_t capacity, int32_t count, const TBlock<void,Channel *> & blk, Context * context, LineInfoArg * at ) {
+        verifyChannelCapacity(capacity, context, at);
+        Channel ch(context,count,uint32_t(capacity));
+        AddReleaseGuard<Channel> guard(&ch, context, at);
+        das_invoke<void>::invoke<Channel *>(context, at, blk, &ch);
+    }
+
+    Channel * boundedChannelCreate( int32_t capacity, Context * context, LineInfoArg * at ) {
+        verifyChannelCapacity(capacity, context, at);
+        Channel * ch = new Channel(context,0,uint32_t(capacity));
+        if ( at ) ch->mCreatedAt = at->describe();
+        ch->addRef(at);
+        return ch;
+    }
+
     void channelRemove( Channel * & ch, Context * context, LineInfoArg * at ) {
         if ( !ch ) context->throw_error_at(at, "channelRemove: channel is null");
         if (!ch->isValid()) context->throw_error_at(at, "channel is invalid (already deleted?)");
@@ -482,6 +806,7 @@ namespace das {
             addProperty<DAS_BIND_MANAGED_PROP(isReady)>("isReady");
             addProperty<DAS_BIND_MANAGED_PROP(size)>("size");
             addProperty<DAS_BIND_MANAGED_PROP(total)>("total");
+            addProperty<DAS_BIND_MANAGED_PROP(capacity)>("capacity");
         }
         virtual int32_t getGcFlags(das_set<Structure *> &, das_set<Annotation *> &) const override {
             return TypeDecl::gcFlag_heap | TypeDecl::gcFlag_stringHeap;
@@ -590,6 +915,18 @@ namespace das {
     };
 
 
+    struct ContextPoolAnnotation : ManagedStructureAnnotation<ContextPool,false> {
+        ContextPoolAnnotation(ModuleLibrary & ml) : ManagedStructureAnnotation ("ContextPool", ml) {
+            addField<DAS_BIND_MANAGED_FIELD(acquired)>("acquired");
+            addField<DAS_BIND_MANAGED_FIELD(reused)>("reused");
+            addField<DAS_BIND_MANAGED_FIELD(created)>("created");
+            addField<DAS_BIND_MANAGED_FIELD(discarded)>("discarded");
+            addField<DAS_BIND_MANAGED_FIELD(createTime)>("createTime");
+            addField<DAS_BIND_MANAGED_FIELD(resetTime)>("resetTime");
+            addProperty<DAS_BIND_MANAGED_PROP(available)>("available");
+        }
+    };
+
     template <typename TT>
     struct AtomicAnnotation : ManagedStructureAnnotation<AtomicTT<TT>,false> {
         AtomicAnnotation(const char * ttname, ModuleLibrary & ml) : ManagedStructureAnnotation<AtomicTT<TT>,false> (ttname, ml) {
@@ -658,6 +995,114 @@ namespace das {
         }).detach();
     }
 
+    // context pool
+
+    ContextPool::ContextPool ( Context * p, int32_t cap ) : proto(p), capacity(cap) {}
+
+    ContextPool::~ContextPool() {
+        lock_guard<mutex> guard(poolMutex);
+        pool.clear();
+    }
+
+    shared_ptr<Context> ContextPool::create() {
+        auto t0 = ref_time_ticks();
+        shared_ptr<Context> ctx;
+        ctx.reset(get_clone_context(proto, uint32_t(ContextCategory::job_clone)));
+        ctx->sharedPtrContext = true;
+        auto dt = get_time_nsec(t0);
+        lock_guard<mutex> guard(poolMutex);
+        created ++;
+        createTime += dt;
+        return ctx;
+    }
+
+    int32_t ContextPool::available() {
+        lock_guard<mutex> guard(poolMutex);
+        return int32_t(pool.size());
+    }
+
+    int32_t ContextPool::prewarm ( int32_t count ) {
+        int32_t added = 0;
+        while ( added < count && available() < capacity ) {
+            auto ctx = create();
+            lock_guard<mutex> guard(poolMutex);
+            pool.push_back(ctx);
+            added ++;
+        }
+        return added;
+    }
+
+    shared_ptr<Context> ContextPool::acquire() {
+        {
+            lock_guard<mutex> guard(poolMutex);
+            acquired ++;
+            if ( !pool.empty() ) {
+                auto ctx = das::move(pool.back());
+                pool.pop_back();
+                reused ++;
+                return ctx;
+            }
+        }
+        return create();
+    }
+
+    // the context is reset here, so the next acquire is cheap. when it is not taken back,
+    // the caller holds the last reference, and the context is destroyed outside of the lock
+    void ContextPool::release ( const shared_ptr<Context> & ctx ) {
+        if ( !ctx ) return;
+        {
+            lock_guard<mutex> guard(poolMutex);
+            if ( int32_t(pool.size()) >= capacity ) {
+                discarded ++;
+                return;
+            }
+        }
+        auto t0 = ref_time_ticks();
+        bool ok = ctx->resetForReuse();
+        auto dt = get_time_nsec(t0);
+        lock_guard<mutex> guard(poolMutex);
+        resetTime += dt;
+        if ( ok && int32_t(pool.size()) < capacity ) {
+            pool.push_back(ctx);
+        } else {
+            discarded ++;
+        }
+    }
+
+    ContextPool * contextPoolCreate ( int32_t capacity, int32_t prewarm, Context * context, LineInfoArg * at ) {
+        if ( capacity <= 0 ) context->throw_error_at(at, "context pool capacity must be positive, got %i", capacity);
+        auto pool = new ContextPool(context, capacity);
+        pool->prewarm(prewarm);
+        return pool;
+    }
+
+    void contextPoolRemove ( ContextPool * & pool, Context * context, LineInfoArg * at ) {
+        if ( !pool ) context->throw_error_at(at, "contextPoolRemove: pool is null");
+        delete pool;
+        pool = nullptr;
+    }
+
+    void withContextPool ( int32_t capacity, int32_t prewarm, const TBlock<void,ContextPool *> & blk, Context * context, LineInfoArg * at ) {
+        if ( capacity <= 0 ) context->throw_error_at(at, "context pool capacity must be positive, got %i", capacity);
+        ContextPool pool(context, capacity);
+        pool.prewarm(prewarm);
+        das_invoke<void>::invoke<ContextPool *>(context, at, blk, &pool);
+    }
+
+    struct PooledContextGuard {
+        PooledContextGuard ( ContextPool * p, shared_ptr<Context> c ) : pool(p), ctx(das::move(c)) {}
+        ~PooledContextGuard () { pool->release(ctx); }
+        ContextPool *       pool;
+        shared_ptr<Context> ctx;
+    };
+
+    void withPooledContext ( ContextPool * pool, const TBlock<void,Context &> & blk, Context * context, LineInfoArg * at ) {
+        if ( !pool ) context->throw_error_at(at, "withPooledContext: pool is null");
+        PooledContextGuard guard(pool, pool->acquire());
+        if ( guard.ctx->failed ) context->throw_error_at(at, "withPooledContext: context initialization failed");
+        das_invoke<void>::invoke<Context &>(context, at, blk, *guard.ctx);
+    }
+
     extern condition_variable debugger_stopped;
     extern atomic<bool>       debugger_started;
     extern atomic<bool>       stopped;
@@ -691,9 +1136,14 @@ namespace das {
     }
 
     void withJobQue ( const TBlock<void> & block, Context * context, LineInfoArg * lineInfo ) {
+        withJobQueBackend(JobQueBackend(g_jobque_backend.load()) == JobQueBackend::WorkStealing, block, context, lineInfo);
+    }
+
+    void withJobQueBackend ( bool workStealing, const TBlock<void> & block, Context * context, LineInfoArg * lineInfo ) {
         if ( !g_jobQue ) {
             lock_guard<mutex> guard(g_jobQueMutex);
-            g_jobQue = make_shared<JobQue>();
+            // nested blocks keep using the job que, which is already there
+            g_jobQue = make_shared<JobQue>(workStealing ? JobQueBackend::WorkStealing : JobQueBackend::Fifo);
         }
         {
             shared_ptr<JobQue> jq = g_jobQue;
@@ -760,6 +1210,11 @@ namespace das {
         return g_jobQue->getTotalHwJobs();
     }
 
+    bool isWorkStealingJobQue( Context * context, LineInfoArg * at ) {
+        if ( !g_jobQue ) context->throw_error_at(at, "need to be in 'with_job_que' block");
+        return g_jobQue->getBackend()==JobQueBackend::WorkStealing;
+    }
+
     int getTotalHwThreads () {
         return JobQue::get_num_threads();
     }
@@ -784,6 +1239,7 @@ namespace das {
             auto stra = new StreamAnnotation(lib);
             stra->from("JobStatus");
             addAnnotation(stra);
+            addAnnotation(new ContextPoolAnnotation(lib));
             auto a32 = new AtomicAnnotation<int32_t>("Atomic32",lib);
             addAnnotation(a32);
             auto a64 = new AtomicAnnotation<int64_t>("Atomic64",lib);
@@ -832,6 +1288,19 @@ namespace das {
             addExtern<DAS_BIND_FUN(atomicDec<int64_t>)>(*this, lib, "dec",
                 SideEffects::modifyArgumentAndExternal, "atomicDec<int64_t>")
                     ->args({ "atomic", "context","line" });
+            // context pool
+            addExtern<DAS_BIND_FUN(contextPoolCreate)>(*this, lib, "context_pool_create",
+                SideEffects::modifyExternal, "contextPoolCreate")
+                    ->args({ "capacity","prewarm","context","line" });
+            addExtern<DAS_BIND_FUN(contextPoolRemove)>(*this, lib, "context_pool_remove",
+                SideEffects::modifyArgumentAndExternal, "contextPoolRemove")
+                    ->args({ "pool","context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(withContextPool)>(*this, lib, "with_context_pool",
+                SideEffects::invoke, "withContextPool")
+                    ->args({ "capacity","prewarm","block","context","line" });
+            addExtern<DAS_BIND_FUN(withPooledContext)>(*this, lib, "with_pooled_context",
+                SideEffects::invoke, "withPooledContext")
+                    ->args({ "pool","block","context","line" });
             // lock box
             addExtern<DAS_BIND_FUN(lockBoxCreate)>(*this, lib, "lock_box_create",
                 SideEffects::invoke, "lockBoxCreate")
@@ -873,6 +1342,12 @@ namespace das {
             addExtern<DAS_BIND_FUN(channelPopWithTimeout)>(*this, lib,  "_builtin_channel_pop_with_timeout",
                 SideEffects::modifyArgumentAndExternal, "channelPopWithTimeout")
                     ->args({"channel","timeout_ms","block","context","line"});
+            addExtern<DAS_BIND_FUN(channelPopBatch)>(*this, lib,  "_builtin_channel_pop_batch",
+                SideEffects::modifyArgumentAndExternal, "channelPopBatch")
+                    ->args({"channel","max_count","block","context","line"});
+            addExtern<DAS_BIND_FUN(channelTryPopBatch)>(*this, lib,  "_builtin_channel_try_pop_batch",
+                SideEffects::modifyArgumentAndExternal, "channelTryPopBatch")
+                    ->args({"channel","max_count","block","context","line"});
             addExtern<DAS_BIND_FUN(channelGather)>(*this, lib,  "_builtin_channel_gather",
                 SideEffects::modifyArgumentAndExternal, "channelGather")
                     ->args({"channel","block","context","line"});
@@ -897,9 +1372,18 @@ namespace das {
             addExtern<DAS_BIND_FUN(withChannelEx)>(*this, lib,  "with_channel",
                 SideEffects::invoke, "withChannelEx")
                     ->args({"count","block","context","line"});
+            addExtern<DAS_BIND_FUN(withBoundedChannel)>(*this, lib,  "with_bounded_channel",
+                SideEffects::invoke, "withBoundedChannel")
+                    ->args({"capacity","block","context","line"});
+            addExtern<DAS_BIND_FUN(withBoundedChannelEx)>(*this, lib,  "with_bounded_channel",
+                SideEffects::invoke, "withBoundedChannelEx")
+                    ->args({"capacity","count","block","context","line"});
             addExtern<DAS_BIND_FUN(channelCreate)>(*this, lib, "channel_create",
                 SideEffects::invoke, "channelCreate")
                     ->args({ "context","line" })->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(boundedChannelCreate)>(*this, lib, "bounded_channel_create",
+                SideEffects::invoke, "boundedChannelCreate")
+                    ->args({ "capacity","context","line" })->unsafeOperation = true;
             addExtern<DAS_BIND_FUN(channelRemove)>(*this, lib, "channel_remove",
                 SideEffects::invoke, "channelRemove")
                     ->args({ "channel", "context","line" })->unsafeOperation = true;
@@ -969,6 +1453,12 @@ namespace das {
             addExtern<DAS_BIND_FUN(withJobQue)>(*this, lib,  "with_job_que",
                 SideEffects::modifyExternal, "withJobQue")
                     ->args({"block","context","line"});
+            addExtern<DAS_BIND_FUN(withJobQueBackend)>(*this, lib,  "with_job_que",
+                SideEffects::modifyExternal, "withJobQueBackend")
+                    ->args({"work_stealing","block","context","line"});
+            addExtern<DAS_BIND_FUN(isWorkStealingJobQue)>(*this, lib,  "is_work_stealing_job_que",
+                SideEffects::accessExternal, "isWorkStealingJobQue")
+                    ->args({"context","line"});
             addExtern<DAS_BIND_FUN(getTotalHwJobs)>(*this, lib,  "get_total_hw_jobs",
                 SideEffects::accessExternal, "getTotalHwJobs")
                     ->args({"context","line"});
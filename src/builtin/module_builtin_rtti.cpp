@@ -880,6 +880,8 @@ namespace das {
             addField<DAS_BIND_MANAGED_FIELD(serialize_main_module)>("serialize_main_module");
             addField<DAS_BIND_MANAGED_FIELD(keep_alive)>("keep_alive");
             addField<DAS_BIND_MANAGED_FIELD(very_safe_context)>("very_safe_context");
+            addField<DAS_BIND_MANAGED_FIELD(incremental_table_resize)>("incremental_table_resize");
+            addField<DAS_BIND_MANAGED_FIELD(parallel_gc_mark)>("parallel_gc_mark");
         // reporting
             addField<DAS_BIND_MANAGED_FIELD(always_report_candidates_threshold)>("always_report_candidates_threshold");
         // infer passes
@@ -889,6 +891,7 @@ namespace das {
             addField<DAS_BIND_MANAGED_FIELD(stack)>("stack");
             addField<DAS_BIND_MANAGED_FIELD(intern_strings)>("intern_strings");
             addField<DAS_BIND_MANAGED_FIELD(persistent_heap)>("persistent_heap");
+            addField<DAS_BIND_MANAGED_FIELD(size_class_heap)>("size_class_heap");
             addField<DAS_BIND_MANAGED_FIELD(multiple_contexts)>("multiple_contexts");
             addField<DAS_BIND_MANAGED_FIELD(heap_size_hint)>("heap_size_hint");
             addField<DAS_BIND_MANAGED_FIELD(string_heap_size_hint)>("string_heap_size_hint");
@@ -939,6 +942,7 @@ namespace das {
             addField<DAS_BIND_MANAGED_FIELD(log_compile_time)>("log_compile_time");
             addField<DAS_BIND_MANAGED_FIELD(log_total_compile_time)>("log_total_compile_time");
             addField<DAS_BIND_MANAGED_FIELD(no_fast_call)>("no_fast_call");
+            addField<DAS_BIND_MANAGED_FIELD(bytecode)>("bytecode");
             addField<DAS_BIND_MANAGED_FIELD(scoped_stack_allocator)>("scoped_stack_allocator");
             addField<DAS_BIND_MANAGED_FIELD(force_inscope_pod)>("force_inscope_pod");
             addField<DAS_BIND_MANAGED_FIELD(log_inscope_pod)>("log_inscope_pod");
@@ -1362,6 +1366,35 @@ namespace das {
         }
     }
 
+    void rtti_builtin_compile_file_cached ( char * modName, char * cacheName, smart_ptr<FileAccess> access, ModuleGroup* module_group, const CodeOfPolicies & cop,
+            const TBlock<void,bool,smart_ptr<Program>,bool,const string> & block, Context * context, LineInfoArg * at ) {
+        if ( !cacheName ) context->throw_error_at(at, "expecting cache file name");
+        TextWriter issues;
+        if ( !access ) access = make_smart<FsFileAccess>();
+        bool cached = false;
+        auto program = compileDaScriptCached(modName, cacheName, access, issues, *module_group, cop, &cached);
+        if ( program ) {
+            bool ok = !program->failed();
+            if ( !ok ) {
+                for (auto & err : program->errors) {
+                    issues << reportError(err.at, err.what, err.extra, err.fixme, err.cerr);
+                }
+            }
+            string istr = issues.str();
+            vec4f args[4] = {
+                cast<bool>::from(ok),
+                cast<smart_ptr<Program>>::from(program),
+                cast<bool>::from(cached),
+                cast<string *>::from(&istr)
+            };
+            if ( ok ) daScriptEnvironment::getBound()->g_Program = program;
+            context->invoke(block, args, nullptr, at);
+            if ( ok ) daScriptEnvironment::getBound()->g_Program.reset();
+        } else {
+            context->throw_error_at(at, "rtti_compile internal error, something went wrong");
+        }
+    }
+
     smart_ptr<FileAccess> makeFileAccess( char * pak, Context *, LineInfoArg * ) {
         return get_file_access(pak);
     }
@@ -1385,6 +1418,11 @@ namespace das {
         context->throw_error_at(at, "not supported with DAS_NO_FILEIO");
     }
 
+    void rtti_builtin_compile_file_cached ( char *, char *, smart_ptr<FileAccess>, ModuleGroup*, const CodeOfPolicies &,
+            const TBlock<void, bool, smart_ptr<Program>, bool, const string> &, Context * context, LineInfoArg * at ) {
+        context->throw_error_at(at, "not supported with DAS_NO_FILEIO");
+    }
+
     bool introduceFile ( smart_ptr_raw<FileAccess>, char *, char *, Context * context, LineInfoArg * at ) {
         context->throw_error_at(at, "not supported with DAS_NO_FILEIO");
         return false;
@@ -1717,6 +1755,9 @@ namespace das {
             addExtern<DAS_BIND_FUN(rtti_builtin_compile_file)>(*this, lib, "compile_file",
                 SideEffects::modifyExternal, "rtti_builtin_compile_file")
                     ->args({"module_name","fileAccess","moduleGroup","codeOfPolicies","block","context","line"});
+            addExtern<DAS_BIND_FUN(rtti_builtin_compile_file_cached)>(*this, lib, "compile_file_cached",
+                SideEffects::modifyExternal, "rtti_builtin_compile_file_cached")
+                    ->args({"module_name","cache_file_name","fileAccess","moduleGroup","codeOfPolicies","block","context","line"});
             addExtern<DAS_BIND_FUN(builtin_expected_errors)>(*this, lib, "for_each_expected_error",
                 SideEffects::modifyExternal, "builtin_expected_errors")
                     ->args({"program","block","context","line"});
@@ -946,6 +946,21 @@ namespace das
         context->collectHeap(info, sheap, validate);
     }
 
+    uint64_t heap_collect_retired ( Context * context, LineInfoArg * info ) {
+        auto bytes = context->retiredBytes;
+        context->collectRetired(info);
+        return bytes;
+    }
+
+    uint64_t heap_retired_bytes ( Context * context ) {
+        return context->retiredBytes;
+    }
+
+    uint4 heap_collect_stats ( Context * context ) {
+        auto & st = context->gcStats;
+        return uint4(st.markUsec, st.sweepUsec, st.markThreads, st.markTasks);
+    }
+
     void heap_report ( Context * context, LineInfoArg * info ) {
         context->heap->report();
         context->reportAnyHeap(info, false, true, false, false);
@@ -1231,6 +1246,7 @@ namespace das
     void builtin_table_free ( Table & tab, int szk, int szv, Context * __context__, LineInfoArg * at ) {
         if ( tab.data ) {
             if ( !tab.isLocked() || tab.hopeless ) {
+                if ( tab.resizeData ) table_finish_resize(__context__, tab, at);
                 uint32_t oldSize = tab.capacity*(szk+szv+sizeof(TableHashKey));
                 __context__->free(tab.data, oldSize, at);
             } else {
@@ -1806,6 +1822,12 @@ namespace das
         return simfn->code && simfn->code->rtti_node_isJit();
     }
 
+    bool das_is_bytecode_function ( const Func func ) {
+        auto simfn = func.PTR;
+        if ( !simfn ) return false;
+        return simfn->code && simfn->code->rtti_node_isBytecode();
+    }
+
     bool das_jit_enabled ( Context * context, LineInfoArg * at ) {
         if ( !context->thisProgram ) context->throw_error_at(at, "can only query for jit during compilation");
         return context->thisProgram->policies.jit_enabled;
@@ -2030,9 +2052,13 @@ namespace das
         addInterop<builtin_json_sprint,char *,vec4f,bool>(*this, lib, "sprint_json",
             SideEffects::modifyExternal, "builtin_json_sprint")
                 ->args({"value","humanReadable"});
-        addInterop<builtin_json_sscan,bool,char *,vec4f>(*this, lib, "sscan_json",
+        auto fnss = addInterop<builtin_json_sscan,bool,char *,vec4f>(*this, lib, "sscan_json",
             SideEffects::modifyArgumentAndExternal, "builtin_json_sscan")
                 ->args({"json","value"});
+        fnss->arguments[0]->type->implicit = true;     // so that it takes elements of the json stream
+        addExtern<DAS_BIND_FUN(builtin_json_stream)>(*this, lib, "split_json_stream",
+            SideEffects::modifyExternal, "builtin_json_stream")
+                ->args({"reader","block","context","at"});
         addExtern<DAS_BIND_FUN(builtin_terminate)>(*this, lib, "terminate",
             SideEffects::modifyExternal, "terminate")
                 ->args({"context","at"});
@@ -2102,6 +2128,15 @@ namespace das
         hcol->unsafeOperation = true;
         hcol->arguments[0]->init = new ExprConstBool(true);
         hcol->arguments[1]->init = new ExprConstBool(false);
+        addExtern<DAS_BIND_FUN(heap_collect_stats)>(*this, lib, "heap_collect_stats",
+            SideEffects::modifyExternal, "heap_collect_stats")
+                ->arg("context");
+        addExtern<DAS_BIND_FUN(heap_collect_retired)>(*this, lib, "heap_collect_retired",
+            SideEffects::modifyExternal, "heap_collect_retired")
+                ->args({"context","at"})->unsafeOperation = true;
+        addExtern<DAS_BIND_FUN(heap_retired_bytes)>(*this, lib, "heap_retired_bytes",
+            SideEffects::modifyExternal, "heap_retired_bytes")
+                ->arg("context");
         addExtern<DAS_BIND_FUN(string_heap_report)>(*this, lib, "string_heap_report",
             SideEffects::modifyExternal, "string_heap_report")
                 ->args({"context","line"});
@@ -2416,6 +2451,9 @@ namespace das
         addExtern<DAS_BIND_FUN(das_is_jit_function)>(*this, lib, "is_jit_function",
                 SideEffects::worstDefault, "das_is_jit_function")
                     ->args({"function"});
+        addExtern<DAS_BIND_FUN(das_is_bytecode_function)>(*this, lib, "is_bytecode_function",
+                SideEffects::worstDefault, "das_is_bytecode_function")
+                    ->args({"function"});
         addExtern<DAS_BIND_FUN(das_jit_enabled)>(*this, lib, "jit_enabled",
             SideEffects::none, "das_jit_enabled")
                 ->args({"context","at"});
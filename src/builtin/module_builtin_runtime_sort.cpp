@@ -5,6 +5,7 @@
 #include "daScript/ast/ast_interop.h"
 #include "daScript/simulate/aot_builtin.h"
 #include "daScript/simulate/sim_policy.h"
+#include "daScript/misc/job_que.h"
 #include "das_qsort_r.h"
 
 namespace das
@@ -89,6 +90,290 @@ namespace das
         });
     }
 
+    // stable comparison sort. block can only run on the calling thread, so indices are sorted and elements are permuted once
+
+    template <typename TT>
+    static void sort_stable_permute ( char * data, int32_t elementSize, int32_t length, TT && less ) {
+        vector<int32_t> index(length);
+        for ( int32_t i=0; i!=length; ++i ) index[i] = i;
+        stable_sort(index.begin(), index.end(), less);
+        vector<char> temp(size_t(length) * elementSize);
+        for ( int32_t i=0; i!=length; ++i ) {
+            memcpy(temp.data() + size_t(i) * elementSize, data + size_t(index[i]) * elementSize, elementSize);
+        }
+        memcpy(data, temp.data(), temp.size());
+    }
+
+    void builtin_sort_stable_array_any_cblock ( Array & arr, int32_t elementSize, int32_t, const Block & cmp, Context * context, LineInfoArg * at ) {
+        if ( arr.size<=1 ) return;
+        array_lock(*context,arr,at);
+        vec4f bargs[2];
+        char * data = arr.data;
+        context->invokeEx(cmp, bargs, nullptr, [&](SimNode * code) {
+            sort_stable_permute(data, elementSize, int32_t(arr.size), [&](int32_t x, int32_t y){
+                bargs[0] = cast<void *>::from(data + size_t(x) * elementSize);
+                bargs[1] = cast<void *>::from(data + size_t(y) * elementSize);
+                return code->evalBool(*context);
+            });
+        }, at);
+        array_unlock(*context,arr,at);
+    }
+
+    void builtin_sort_stable_array_any_ref_cblock ( Array & arr, int32_t elementSize, int32_t, const Block & cmp, Context * context, LineInfoArg * at ) {
+        if ( arr.size<=1 ) return;
+        array_lock(*context,arr,at);
+        vec4f bargs[2];
+        char * data = arr.data;
+        context->invokeEx(cmp, bargs, nullptr, [&](SimNode * code) {
+            sort_stable_permute(data, elementSize, int32_t(arr.size), [&](int32_t x, int32_t y){
+                const char * px = data + size_t(x) * elementSize;
+                const char * py = data + size_t(y) * elementSize;
+                if ( elementSize <= 4 ) {
+                    bargs[0] = v_ldu_x((const float *)px);
+                    bargs[1] = v_ldu_x((const float *)py);
+                } else if ( elementSize <= 8 ) {
+                    bargs[0] = v_ldu_half(px);
+                    bargs[1] = v_ldu_half(py);
+                } else {
+                    bargs[0] = v_ldu((const float *)px);
+                    bargs[1] = v_ldu((const float *)py);
+                }
+                return code->evalBool(*context);
+            });
+        }, at);
+        array_unlock(*context,arr,at);
+    }
+
+    // parallel sorts. without job que, or below the size threshold, everything runs on the calling thread
+
+    extern mutex              g_jobQueMutex;
+    extern shared_ptr<JobQue> g_jobQue;
+
+    static constexpr int32_t parallelSortMinLength = 32768;
+
+    static shared_ptr<JobQue> sort_job_que ( int32_t length ) {
+        if ( length < parallelSortMinLength ) return nullptr;
+        lock_guard<mutex> guard(g_jobQueMutex);
+        return g_jobQue;
+    }
+
+    static int32_t sort_parts ( JobQue * jobQue, int32_t length ) {
+        if ( !jobQue ) return 1;
+        return max(min(jobQue->getTotalHwJobs(), length / (parallelSortMinLength / 4)), 1);
+    }
+
+    template <typename TT>
+    static void sort_for_each_part ( JobQue * jobQue, int32_t parts, TT && fn ) {
+        if ( parts==1 ) {
+            fn(0);
+        } else {
+            jobQue->parallel_for(0, parts, [&](int i0, int i1) {
+                for ( int p=i0; p!=i1; ++p ) fn(p);
+            }, 0, JobPriority::Default, parts, 1);
+        }
+    }
+
+    // stable merge sort. runs are sorted on job que workers, then pairs of runs are merged (also in parallel) until one is left
+    template <typename TT, typename LessTT>
+    static void parallel_merge_sort ( TT * data, int32_t length, LessTT && less ) {
+        auto jobQue = sort_job_que(length);
+        int32_t runs = sort_parts(jobQue.get(), length);
+        if ( runs==1 ) {
+            stable_sort(data, data + length, less);
+            return;
+        }
+        int32_t runLength = (length + runs - 1) / runs;
+        sort_for_each_part(jobQue.get(), runs, [&](int32_t r) {
+            int32_t lo = r * runLength;
+            int32_t hi = min(lo + runLength, length);
+            if ( lo < hi ) stable_sort(data + lo, data + hi, less);
+        });
+        vector<TT> temp(length);
+        TT * src = data;
+        TT * dst = temp.data();
+        for ( int32_t width = runLength; width < length; width *= 2 ) {
+            int32_t pairs = (length + 2 * width - 1) / (2 * width);
+            sort_for_each_part(jobQue.get(), pairs, [&](int32_t p) {
+                int32_t lo = p * 2 * width;
+                int32_t mid = min(lo + width, length);
+                int32_t hi = min(lo + 2 * width, length);
+                merge(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+            });
+            swap(src, dst);
+        }
+        if ( src != data ) memcpy(data, src, size_t(length) * sizeof(TT));
+    }
+
+    // order preserving mapping of numeric keys to unsigned integers
+    template <typename TT> struct radix_bits;
+    template <> struct radix_bits<int32_t> {
+        typedef uint32_t type;
+        static __forceinline uint32_t to ( int32_t v ) { return uint32_t(v) ^ 0x80000000u; }
+    };
+    template <> struct radix_bits<uint32_t> {
+        typedef uint32_t type;
+        static __forceinline uint32_t to ( uint32_t v ) { return v; }
+    };
+    template <> struct radix_bits<int64_t> {
+        typedef uint64_t type;
+        static __forceinline uint64_t to ( int64_t v ) { return uint64_t(v) ^ 0x8000000000000000ull; }
+    };
+    template <> struct radix_bits<uint64_t> {
+        typedef uint64_t type;
+        static __forceinline uint64_t to ( uint64_t v ) { return v; }
+    };
+    template <> struct radix_bits<float> {
+        typedef uint32_t type;
+        static __forceinline uint32_t to ( float v ) {
+            uint32_t u; memcpy(&u, &v, sizeof(u));
+            return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+        }
+    };
+    template <> struct radix_bits<double> {
+        typedef uint64_t type;
+        static __forceinline uint64_t to ( double v ) {
+            uint64_t u; memcpy(&u, &v, sizeof(u));
+            return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+        }
+    };
+
+    // LSD radix sort, 8 bits per pass. passes where all items share the digit are skipped.
+    // with job que each part counts and scatters its own items into its own slice of every bucket, which keeps the sort stable.
+    // returns where the sorted items ended up, data or temp
+    template <typename ItemTT, typename KeyTT>
+    static ItemTT * radix_sort_items ( ItemTT * data, ItemTT * temp, int32_t length, KeyTT && keyOf ) {
+        typedef decltype(keyOf(*data)) UKey;
+        auto jobQue = sort_job_que(length);
+        int32_t parts = sort_parts(jobQue.get(), length);
+        int32_t partLength = (length + parts - 1) / parts;
+        vector<uint32_t> counts(size_t(parts) * 256);
+        ItemTT * src = data;
+        ItemTT * dst = temp;
+        for ( int32_t shift = 0; shift != int32_t(sizeof(UKey) * 8); shift += 8 ) {
+            sort_for_each_part(jobQue.get(), parts, [&](int32_t p) {
+                uint32_t * cnt = counts.data() + p * 256;
+                memset(cnt, 0, 256 * sizeof(uint32_t));
+                int32_t hi = min((p + 1) * partLength, length);
+                for ( int32_t i = p * partLength; i < hi; ++i ) {
+                    cnt[(keyOf(src[i]) >> shift) & 255] ++;
+                }
+            });
+            bool skip = false;
+            for ( int32_t d = 0; d != 256 && !skip; ++d ) {
+                uint32_t total = 0;
+                for ( int32_t p = 0; p != parts; ++p ) total += counts[p * 256 + d];
+                skip = total == uint32_t(length);
+            }
+            if ( skip ) continue;
+            uint32_t base = 0;
+            for ( int32_t d = 0; d != 256; ++d ) {
+                for ( int32_t p = 0; p != parts; ++p ) {
+                    uint32_t & c = counts[p * 256 + d];
+                    uint32_t next = base + c;
+                    c = base;
+                    base = next;
+                }
+            }
+            sort_for_each_part(jobQue.get(), parts, [&](int32_t p) {
+                uint32_t * offs = counts.data() + p * 256;
+                int32_t hi = min((p + 1) * partLength, length);
+                for ( int32_t i = p * partLength; i < hi; ++i ) {
+                    dst[offs[(keyOf(src[i]) >> shift) & 255] ++] = src[i];
+                }
+            });
+            swap(src, dst);
+        }
+        return src;
+    }
+
+    template <typename TT>
+    static void radix_sort_values ( TT * data, int32_t length ) {
+        vector<TT> temp(length);
+        auto res = radix_sort_items(data, temp.data(), length, [](TT v) { return radix_bits<TT>::to(v); });
+        if ( res != data ) memcpy(data, res, size_t(length) * sizeof(TT));
+    }
+
+    template <typename UKey>
+    struct RadixKeyIndex {
+        UKey        key;
+        int32_t     index;
+    };
+
+    // records are not moved around while sorting. keys are sorted together with the record index, then records are permuted once
+    template <typename KT>
+    static void sort_records_by_key ( char * data, int32_t elementSize, int32_t length, const KT * keys, bool descending ) {
+        typedef typename radix_bits<KT>::type UKey;
+        UKey flip = descending ? UKey(~UKey(0)) : UKey(0);
+        vector<RadixKeyIndex<UKey>> items(length), temp(length);
+        for ( int32_t i=0; i!=length; ++i ) {
+            items[i].key = radix_bits<KT>::to(keys[i]) ^ flip;
+            items[i].index = i;
+        }
+        auto sorted = radix_sort_items(items.data(), temp.data(), length, [](const RadixKeyIndex<UKey> & it) { return it.key; });
+        vector<char> records(size_t(length) * elementSize);
+        auto jobQue = sort_job_que(length);
+        int32_t parts = sort_parts(jobQue.get(), length);
+        int32_t partLength = (length + parts - 1) / parts;
+        sort_for_each_part(jobQue.get(), parts, [&](int32_t p) {
+            int32_t hi = min((p + 1) * partLength, length);
+            for ( int32_t i = p * partLength; i < hi; ++i ) {
+                memcpy(records.data() + size_t(i) * elementSize, data + size_t(sorted[i].index) * elementSize, elementSize);
+            }
+        });
+        memcpy(data, records.data(), records.size());
+    }
+
+    template <typename TT>
+    static void parallel_sort_values ( TT * data, int32_t length ) {
+        parallel_merge_sort(data, length, [](TT a, TT b){ return a<b; });
+    }
+
+    void builtin_sort_parallel_any ( void * data, int32_t length, SortKey key ) {
+        if ( length<=1 ) return;
+        switch ( key ) {
+            case SortKey::Int:      parallel_sort_values((int32_t *)data, length); break;
+            case SortKey::UInt:     parallel_sort_values((uint32_t *)data, length); break;
+            case SortKey::Int64:    parallel_sort_values((int64_t *)data, length); break;
+            case SortKey::UInt64:   parallel_sort_values((uint64_t *)data, length); break;
+            case SortKey::Float:    parallel_sort_values((float *)data, length); break;
+            case SortKey::Double:   parallel_sort_values((double *)data, length); break;
+        }
+    }
+
+    void builtin_sort_string_parallel ( void * data, int32_t length ) {
+        if ( length<=1 ) return;
+        parallel_merge_sort((const char **)data, length, [](const char * a, const char * b){
+            return strcmp(to_rts(a), to_rts(b))<0;
+        });
+    }
+
+    void builtin_sort_radix_any ( void * data, int32_t length, SortKey key ) {
+        if ( length<=1 ) return;
+        switch ( key ) {
+            case SortKey::Int:      radix_sort_values((int32_t *)data, length); break;
+            case SortKey::UInt:     radix_sort_values((uint32_t *)data, length); break;
+            case SortKey::Int64:    radix_sort_values((int64_t *)data, length); break;
+            case SortKey::UInt64:   radix_sort_values((uint64_t *)data, length); break;
+            case SortKey::Float:    radix_sort_values((float *)data, length); break;
+            case SortKey::Double:   radix_sort_values((double *)data, length); break;
+        }
+    }
+
+    void builtin_sort_by_key_any ( Array & arr, int32_t elementSize, const void * keys, int32_t numKeys, SortKey key, bool descending, Context * context, LineInfoArg * at ) {
+        if ( int32_t(arr.size)!=numKeys ) context->throw_error_at(at, "sort_by_key: expecting %i keys, got %i", int32_t(arr.size), numKeys);
+        if ( arr.size<=1 ) return;
+        array_lock(*context,arr,at);
+        switch ( key ) {
+            case SortKey::Int:      sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const int32_t *)keys, descending); break;
+            case SortKey::UInt:     sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const uint32_t *)keys, descending); break;
+            case SortKey::Int64:    sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const int64_t *)keys, descending); break;
+            case SortKey::UInt64:   sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const uint64_t *)keys, descending); break;
+            case SortKey::Float:    sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const float *)keys, descending); break;
+            case SortKey::Double:   sort_records_by_key(arr.data, elementSize, int32_t(arr.size), (const double *)keys, descending); break;
+        }
+        array_unlock(*context,arr,at);
+    }
+
 #define xstr(a) str(a)
 #define str(a) #a
 
@@ -106,6 +391,17 @@ namespace das
         SideEffects::modifyArgumentAndExternal, "builtin_sort_dim_any_ref_cblock_T") \
             ->args({"array","stride","length","block","context","line"})->setAotTemplate()->setAnyTemplate();
 
+#define ADD_PARALLEL_SORT(CTYPE) \
+    addExtern<DAS_BIND_FUN(builtin_sort_parallel<CTYPE>)>(*this, lib, "__builtin_sort_parallel", \
+        SideEffects::modifyArgumentAndExternal, "builtin_sort_parallel<" xstr(CTYPE) ">") \
+            ->args({"data","length"}); \
+    addExtern<DAS_BIND_FUN(builtin_sort_radix<CTYPE>)>(*this, lib, "__builtin_sort_radix", \
+        SideEffects::modifyArgumentAndExternal, "builtin_sort_radix<" xstr(CTYPE) ">") \
+            ->args({"data","length"}); \
+    addExtern<DAS_BIND_FUN(builtin_sort_by_key<CTYPE>)>(*this, lib, "__builtin_sort_by_key", \
+        SideEffects::modifyArgumentAndExternal, "builtin_sort_by_key<" xstr(CTYPE) ">") \
+            ->args({"array","stride","keys","descending","context","line"});
+
 #define ADD_VECTOR_SORT(CTYPE) \
     addExtern<DAS_BIND_FUN(builtin_sort_cblock<CTYPE>)>(*this, lib, "__builtin_sort_cblock", \
         SideEffects::modifyArgumentAndExternal, "builtin_sort_cblock<" xstr(CTYPE) ">") \
@@ -191,6 +487,16 @@ namespace das
         ADD_NUMERIC_SORT(uint64_t);
         ADD_NUMERIC_SORT(float);
         ADD_NUMERIC_SORT(double);
+        // parallel, radix, by key
+        ADD_PARALLEL_SORT(int32_t);
+        ADD_PARALLEL_SORT(uint32_t);
+        ADD_PARALLEL_SORT(int64_t);
+        ADD_PARALLEL_SORT(uint64_t);
+        ADD_PARALLEL_SORT(float);
+        ADD_PARALLEL_SORT(double);
+        addExtern<DAS_BIND_FUN(builtin_sort_string_parallel)>(*this, lib, "__builtin_sort_string_parallel",
+            SideEffects::modifyArgumentAndExternal, "builtin_sort_string_parallel")
+                ->args({"data","length"});
         // vector
         ADD_VECTOR_SORT(range);
         ADD_VECTOR_SORT(urange);
@@ -232,6 +538,13 @@ namespace das
         addExtern<DAS_BIND_FUN(builtin_sort_array_any_ref_cblock)>(*this, lib, "__builtin_sort_array_any_ref_cblock",
             SideEffects::modifyArgumentAndExternal, "builtin_sort_array_any_ref_cblock_T")
                 ->args({"array","stride","length","block","context","line"})->setAotTemplate();
+        // stable array sort
+        addExtern<DAS_BIND_FUN(builtin_sort_stable_array_any_cblock)>(*this, lib, "__builtin_sort_stable_array_any_cblock",
+            SideEffects::modifyArgumentAndExternal, "builtin_sort_stable_array_any_cblock")
+                ->args({"array","stride","length","block","context","line"});
+        addExtern<DAS_BIND_FUN(builtin_sort_stable_array_any_ref_cblock)>(*this, lib, "__builtin_sort_stable_array_any_ref_cblock",
+            SideEffects::modifyArgumentAndExternal, "builtin_sort_stable_array_any_ref_cblock")
+                ->args({"array","stride","length","block","context","line"});
         // dim sort
         addExtern<DAS_BIND_FUN(builtin_sort_dim_any_cblock)>(*this, lib, "__builtin_sort_dim_any_cblock",
             SideEffects::modifyArgumentAndExternal, "builtin_sort_dim_any_cblock_T")
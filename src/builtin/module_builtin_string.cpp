@@ -471,8 +471,7 @@ namespace das
 
     StringBuilderWriter & write_escape_string ( StringBuilderWriter & writer, char * str ) {
         if ( !str ) return writer;
-        auto estr = escapeString(str,false);
-        writer.writeStr(estr.c_str(), estr.length());
+        escapeString(writer, str, strlen(str), false);
         return writer;
     }
 
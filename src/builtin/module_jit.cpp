@@ -107,9 +107,110 @@ namespace das {
         return res;
     }
 
+    // tiered jit
+    //  a function starts on the interpreter, with the counting node in front of its code. once it is called
+    //  'threshold' times it becomes hot, and the compiler (which may run on another thread) picks it up with
+    //  take_hot_jit_tier_up. the compiler publishes native code with install_jit_tier_up, and the next call
+    //  on the thread of the context replaces the counting node with SimNode_Jit
+    enum JitTierUpState : uint32_t {
+        JitTierUp_Counting,
+        JitTierUp_Hot,
+        JitTierUp_Compiling,
+        JitTierUp_Compiled,
+    };
+
+    struct SimNode_JitTierUp : SimNode {
+        SimNode_JitTierUp ( const LineInfo & at, SimFunction * fn, uint32_t th )
+            : SimNode(at), simfn(fn), saved_code(fn->code), threshold(th) {}
+        virtual SimNode * visit ( SimVisitor & vis ) override;
+        DAS_EVAL_ABI virtual vec4f eval ( Context & context ) override;
+        virtual bool rtti_node_isJitTierUp() const override { return true; }
+        SimNode * install ( Context & context, JitFunction pfun );
+        SimFunction * simfn = nullptr;
+        // saved original node
+        SimNode * saved_code = nullptr;
+        uint32_t threshold = 0;
+        atomic<uint32_t> calls {0};
+        atomic<uint32_t> state {JitTierUp_Counting};
+        atomic<JitFunction> compiled {nullptr};
+    };
+
+    SimNode * SimNode_JitTierUp::visit ( SimVisitor & vis ) {
+        V_BEGIN();
+        V_OP(JitTierUp);
+        V_ARG(threshold);
+        V_SUB(saved_code);
+        V_END();
+    }
+
+    SimNode * SimNode_JitTierUp::install ( Context & context, JitFunction pfun ) {
+        auto node = context.code->makeNode<SimNode_Jit>(debugInfo, pfun);
+        node->saved_code = saved_code;
+        simfn->code = node;
+        simfn->jit = true;
+        return node;
+    }
+
+    vec4f SimNode_JitTierUp::eval ( Context & context ) {
+        if ( auto pfun = compiled.load(memory_order_acquire) ) {
+            return install(context, pfun)->eval(context);
+        }
+        if ( calls.fetch_add(1, memory_order_relaxed) + 1 == threshold ) {
+            state.store(JitTierUp_Hot, memory_order_release);
+        }
+        return saved_code->eval(context);
+    }
+
+    static SimNode_JitTierUp * getJitTierUp ( SimFunction * simfn ) {
+        if ( !simfn || !simfn->code || !simfn->code->rtti_node_isJitTierUp() ) return nullptr;
+        return static_cast<SimNode_JitTierUp *>(simfn->code);
+    }
+
+    bool das_instrument_jit_tier_up ( const Func func, int32_t threshold, Context & context ) {
+        auto simfn = func.PTR;
+        if ( !simfn || !simfn->code || simfn->jit || simfn->aot || threshold<=0 ) return false;
+        if ( getJitTierUp(simfn) ) return false;
+        simfn->code = context.code->makeNode<SimNode_JitTierUp>(simfn->code->debugInfo, simfn, uint32_t(threshold));
+        return true;
+    }
+
+    int32_t das_jit_tier_up_calls ( const Func func ) {
+        auto tier = getJitTierUp(func.PTR);
+        return tier ? int32_t(tier->calls.load(memory_order_relaxed)) : -1;
+    }
+
+    // can be called from any thread. the function is only handed out once
+    int32_t das_take_hot_jit_tier_up ( Context & context, const TBlock<void,Func> & block, Context * callContext, LineInfoArg * at ) {
+        int32_t taken = 0;
+        for ( int i=0, is=context.getTotalFunctions(); i!=is; ++i ) {
+            auto simfn = context.getFunction(i);
+            auto tier = getJitTierUp(simfn);
+            if ( !tier ) continue;
+            uint32_t hot = JitTierUp_Hot;
+            if ( !tier->state.compare_exchange_strong(hot, JitTierUp_Compiling) ) continue;
+            vec4f args[1] = { cast<Func>::from(Func(simfn)) };
+            callContext->invoke(block, args, nullptr, at);
+            taken ++;
+        }
+        return taken;
+    }
+
+    // can be called from any thread. code is installed on the next call of the function
+    bool das_install_jit_tier_up ( const Func func, void * pfun ) {
+        auto tier = getJitTierUp(func.PTR);
+        if ( !tier || !pfun ) return false;
+        tier->compiled.store((JitFunction)pfun, memory_order_release);
+        tier->state.store(JitTierUp_Compiled, memory_order_release);
+        return true;
+    }
+
     bool das_remove_jit ( const Func func ) {
         auto simfn = func.PTR;
         if ( !simfn ) return false;
+        if ( auto tier = getJitTierUp(simfn) ) {
+            simfn->code = tier->saved_code;
+            return true;
+        }
         if ( simfn->code && simfn->code->rtti_node_isJit() ) {
             auto jitNode = static_cast<SimNode_Jit *>(simfn->code);
             simfn->code = jitNode->saved_code;
@@ -132,7 +233,8 @@ namespace das {
             jitNode->debugInfo = lineInfo;
         } else {
             auto node = context.code->makeNode<SimNode_Jit>(lineInfo, (JitFunction)pfun);
-            node->saved_code = simfn->code;
+            auto tier = getJitTierUp(simfn);
+            node->saved_code = tier ? tier->saved_code : simfn->code;
             node->saved_aot = simfn->aot;
             node->saved_aot_function = simfn->aotFunction;
             simfn->code = node;
@@ -459,6 +561,7 @@ extern "C" {
         pp->functionLine = (LineInfo *) funcLineInfo;
         pp->stackSize = stackSize;
         pp->is_jit = true;
+        DAS_PROFILE_SAMPLE(*context);
 #endif
     }
 
@@ -898,6 +1001,18 @@ extern "C" {
             addExtern<DAS_BIND_FUN(das_remove_jit)>(*this, lib, "remove_jit",
                 SideEffects::worstDefault, "das_remove_jit")
                     ->args({"function"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_instrument_jit_tier_up)>(*this, lib, "instrument_jit_tier_up",
+                SideEffects::worstDefault, "das_instrument_jit_tier_up")
+                    ->args({"function","threshold","context"})->unsafeOperation = true;
+            addExtern<DAS_BIND_FUN(das_jit_tier_up_calls)>(*this, lib, "jit_tier_up_calls",
+                SideEffects::accessExternal, "das_jit_tier_up_calls")
+                    ->args({"function"});
+            addExtern<DAS_BIND_FUN(das_take_hot_jit_tier_up)>(*this, lib, "take_hot_jit_tier_up",
+                SideEffects::worstDefault, "das_take_hot_jit_tier_up")
+                    ->args({"context","block","callContext","at"});
+            addExtern<DAS_BIND_FUN(das_install_jit_tier_up)>(*this, lib, "install_jit_tier_up",
+                SideEffects::worstDefault, "das_install_jit_tier_up")
+                    ->args({"function","code"})->unsafeOperation = true;
             addExtern<DAS_BIND_FUN(das_instrument_line_info)>(*this, lib, "instrument_line_info",
                 SideEffects::worstDefault, "das_instrument_line_info")
                     ->args({"info","context","at"});
@@ -19,5 +19,6 @@ DAS_API das::atomic<uint64_t> das::g_smart_ptr_total {0};
 
 DAS_API das::atomic<uint64_t> das::g_jobque_track_total {0};
 DAS_API das::atomic<uint64_t> das::g_jobque_track_id {0};
+DAS_API das::atomic<int32_t>  das::g_jobque_backend {0};
 das::JobStatus *    das::JobStatus::sTrackHead = nullptr;
 das::mutex          das::JobStatus::sTrackMutex;
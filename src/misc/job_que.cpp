@@ -29,24 +29,46 @@ namespace das {
 
 #endif
 
-    JobQue::JobQue()
+    // work stealing worker, which runs on the current thread
+    static DAS_THREAD_LOCAL(JobQue *) g_stealQue;
+    static DAS_THREAD_LOCAL(int32_t) g_stealWorker;
+
+    JobQue::JobQue() : JobQue(JobQueBackend(g_jobque_backend.load())) {
+    }
+
+    JobQue::JobQue( JobQueBackend backend )
         : mSleepMs(1)
         , mShutdown(false)
         , mThreadCount( 0 )
-        , mJobsRunning(0) {
+        , mJobsRunning(0)
+        , mBackend(backend) {
         mThreadCount = get_num_threads();
         SetCurrentThreadPriority(JobPriority::High);
+        if ( mBackend==JobQueBackend::WorkStealing ) {
+            for (int j = 0, js = mThreadCount; j < js; j++) {
+                mStealWorkers.emplace_back(make_unique<StealWorker>());
+            }
+        }
         for (int j = 0, js = mThreadCount; j < js; j++) {
             mThreads.emplace_back(make_unique<thread>([this, j]() {
                 string thread_name = "JobQue_Job_" + to_string(j);
                 SetCurrentThreadName(thread_name);
-                job(j);
+                if ( mBackend==JobQueBackend::WorkStealing ) {
+                    stealJob(j);
+                } else {
+                    job(j);
+                }
             }));
         }
     }
 
     JobQue::~JobQue () {
         join();
+        // jobs which never ran
+        for ( auto & worker : mStealWorkers ) {
+            while ( auto job = worker->jobs.steal() ) delete job;
+            for ( auto job : worker->inject ) delete job;
+        }
     }
 
     void JobQue::EvalOnMainThread(Job && expr) {
@@ -87,7 +109,8 @@ namespace das {
 
     bool JobQue::isEmpty ( bool includingMainThreadJobs ) {
         lock_guard<mutex> lock(mFifoMutex);
-        bool queue_is_empty = (mJobsRunning == 0) && (mFifo.size() == 0);
+        // work stealing jobs count as running before they leave the queue, so check the queue first
+        bool queue_is_empty = (mStealQueued == 0) && (mJobsRunning == 0) && (mFifo.size() == 0);
         if ( includingMainThreadJobs ) {
             lock_guard<mutex> mainThreadLock(mEvalMainThreadMutex);
             return queue_is_empty && mEvalMainThread.empty();
@@ -96,6 +119,7 @@ namespace das {
     }
 
     bool JobQue::areJobsPending(JobCategory category) {
+        if ( category==0 && (mStealQueued || mStealRunning) ) return true;
         lock_guard<mutex> lock(mFifoMutex);
         if (find_if(mFifo.begin(), mFifo.end(), [=](const JobEntry& jobEntry) {
                 return jobEntry.category == category; }) != mFifo.end()) {
@@ -114,16 +138,22 @@ namespace das {
 
     int JobQue::getNumberOfQueuedJobs() {
         lock_guard<mutex> lock(mFifoMutex);
-        return int(mFifo.size());
+        return int(mFifo.size()) + mStealQueued;
     }
 
     void JobQue::submit(Job && job, JobCategory category, JobPriority priority) {
         auto  it = lower_bound(mFifo.begin(), mFifo.end(), priority, [](const JobEntry& lhs, JobPriority priority) {
             return lhs.priority >= priority; });
         mFifo.emplace(it, das::move(job), category, priority);
+        mFifoSize++;
     }
 
     void JobQue::push(Job && job, JobCategory category, JobPriority priority) {
+        if ( isStealJob(category, priority) ) {
+            pushSteal(new Job(das::move(job)));
+            mCond.notify_one();
+            return;
+        }
         lock_guard<mutex> lock(mFifoMutex);
         submit(das::move(job), category, priority);
         mCond.notify_one();
@@ -140,6 +170,7 @@ namespace das {
                     mThreads[threadIndex].currentPriority = mFifo.front().priority;
                     mThreads[threadIndex].currentCategory = mFifo.front().category;
                     mFifo.pop_front();
+                    mFifoSize--;
                     mJobsRunning++;
                 } else {
                     this_thread::yield();
@@ -157,6 +188,170 @@ namespace das {
         mThreadCount--;
     }
 
+    // work stealing
+
+    JobDeque::JobDeque() {
+        mRings.emplace_back(make_unique<Ring>(256));
+        mRing.store(mRings.back().get(), memory_order_relaxed);
+    }
+
+    void JobDeque::push ( Job * job ) {
+        int64_t b = mBottom.load(memory_order_relaxed);
+        int64_t t = mTop.load(memory_order_acquire);
+        Ring * ring = mRing.load(memory_order_relaxed);
+        if ( b - t > ring->mask ) {
+            auto bigger = make_unique<Ring>((ring->mask + 1) * 2);
+            for ( int64_t i=t; i!=b; ++i ) {
+                bigger->put(i, ring->get(i));
+            }
+            ring = bigger.get();
+            mRings.emplace_back(das::move(bigger));
+            mRing.store(ring, memory_order_release);
+        }
+        ring->put(b, job);
+        atomic_thread_fence(memory_order_release);
+        mBottom.store(b + 1, memory_order_relaxed);
+    }
+
+    Job * JobDeque::take() {
+        int64_t b = mBottom.load(memory_order_relaxed) - 1;
+        Ring * ring = mRing.load(memory_order_relaxed);
+        mBottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t t = mTop.load(memory_order_relaxed);
+        if ( t > b ) {
+            mBottom.store(b + 1, memory_order_relaxed);
+            return nullptr;
+        }
+        Job * job = ring->get(b);
+        if ( t == b ) {
+            // last job, thieves may be after it too
+            if ( !mTop.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed) ) {
+                job = nullptr;
+            }
+            mBottom.store(b + 1, memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job * JobDeque::steal() {
+        int64_t t = mTop.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t b = mBottom.load(memory_order_acquire);
+        if ( t >= b ) return nullptr;
+        Ring * ring = mRing.load(memory_order_acquire);
+        Job * job = ring->get(t);
+        if ( !mTop.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed) ) {
+            return nullptr;     // lost the race, caller looks elsewhere
+        }
+        return job;
+    }
+
+    void JobQue::pushSteal ( Job * job ) {
+        mStealQueued++;
+        if ( *g_stealQue==this ) {
+            mStealWorkers[*g_stealWorker]->jobs.push(job);
+        } else {
+            auto & worker = *mStealWorkers[mStealNext++ % mStealWorkers.size()];
+            lock_guard<mutex> lock(worker.injectMutex);
+            worker.inject.push_back(job);
+            worker.injectSize++;
+        }
+    }
+
+    Job * JobQue::popInject ( StealWorker & worker, bool tryLock ) {
+        if ( worker.injectSize==0 ) return nullptr;
+        unique_lock<mutex> lock(worker.injectMutex, defer_lock);
+        if ( tryLock ) {
+            if ( !lock.try_lock() ) return nullptr;
+        } else {
+            lock.lock();
+        }
+        if ( worker.inject.empty() ) return nullptr;
+        Job * job = worker.inject.front();
+        worker.inject.pop_front();
+        worker.injectSize--;
+        return job;
+    }
+
+    Job * JobQue::findSteal ( int threadIndex, uint32_t & seed ) {
+        auto & self = *mStealWorkers[threadIndex];
+        if ( auto job = self.jobs.take() ) return job;
+        if ( auto job = popInject(self, false) ) return job;
+        uint32_t count = uint32_t(mStealWorkers.size());
+        for ( uint32_t i=0; i!=count; ++i ) {
+            seed = seed * 1664525u + 1013904223u;
+            auto & victim = *mStealWorkers[(seed >> 8) % count];
+            if ( &victim==&self ) continue;
+            if ( auto job = victim.jobs.steal() ) return job;
+            if ( auto job = popInject(victim, true) ) return job;
+        }
+        return nullptr;
+    }
+
+    bool JobQue::popFifo ( int threadIndex, Job & job ) {
+        if ( mFifoSize==0 ) return false;
+        lock_guard<mutex> lock(mFifoMutex);
+        if ( mFifo.empty() ) return false;
+        job = das::move(mFifo.front().function);
+        mThreads[threadIndex].currentPriority = mFifo.front().priority;
+        mThreads[threadIndex].currentCategory = mFifo.front().category;
+        mFifo.pop_front();
+        mFifoSize--;
+        mJobsRunning++;
+        return true;
+    }
+
+    void JobQue::stealJob ( int threadIndex ) {
+        *g_stealQue = this;
+        *g_stealWorker = threadIndex;
+        uint32_t seed = uint32_t(threadIndex + 1) * 2654435761u;
+        int idle = 0;
+        JobPriority priority = JobPriority::Inactive;
+        while (!mShutdown) {
+            // priority and category jobs first, they never go to the deques
+            Job fifoJob;
+            if ( popFifo(threadIndex, fifoJob) ) {
+                if ( priority!=mThreads[threadIndex].currentPriority ) {
+                    priority = mThreads[threadIndex].currentPriority;
+                    SetCurrentThreadPriority(priority);
+                }
+                fifoJob();
+                {
+                    lock_guard<mutex> lock(mFifoMutex);
+                    mThreads[threadIndex].currentPriority = JobPriority::Inactive;
+                    mJobsRunning--;
+                }
+                idle = 0;
+                continue;
+            }
+            if ( Job * job = findSteal(threadIndex, seed) ) {
+                mJobsRunning++;
+                mStealRunning++;
+                mStealQueued--;
+                if ( priority!=JobPriority::Default ) {
+                    priority = JobPriority::Default;
+                    SetCurrentThreadPriority(priority);
+                }
+                (*job)();
+                delete job;
+                mStealRunning--;
+                mJobsRunning--;
+                idle = 0;
+                continue;
+            }
+            // spin a little, then sleep until something is pushed
+            if ( ++idle < 64 ) {
+                this_thread::yield();
+            } else {
+                unique_lock<mutex> lock(mFifoMutex);
+                mCond.wait_for(lock, chrono::milliseconds(mSleepMs), [&]() { return mFifo.size() != 0 || mStealQueued != 0; });
+            }
+        }
+        *g_stealQue = nullptr;
+        mThreadCount--;
+    }
+
     void JobQue::parallel_for ( JobStatus & status, int from, int to, const JobChunk & chunk,
             JobCategory category, JobPriority priority, int chunk_count, int step ) {
         if ( from >= to ) return;
@@ -170,7 +365,17 @@ namespace das {
         int onMainThread = max ( (numChunks + mThreadCount)  / (mThreadCount+1), 1 );
         int onThreads  = numChunks - onMainThread;
         status.Clear(onThreads);
-        {
+        if ( isStealJob(category, priority) ) {
+            for (int ch = 0; ch < onThreads; ++ch) {
+                int i0 = from + ch * step;
+                int i1 = i0 + step;
+                pushSteal(new Job([=,&status](){
+                    chunk(i0, i1);
+                    status.Notify();
+                }));
+            }
+            mCond.notify_all();
+        } else {
             lock_guard<mutex> lock(mFifoMutex);
             for (int ch = 0; ch < onThreads; ++ch) {
                 int i0 = from + ch * step;
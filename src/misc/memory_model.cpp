@@ -296,6 +296,162 @@ namespace das {
         }
     }
 
+    SizeClassModel::SizeClassModel () {
+        for ( uint32_t si=0; si!=DAS_SIZE_CLASS_COUNT; ++si ) {
+            partial[si] = nullptr;
+        }
+    }
+
+    SizeClassModel::~SizeClassModel () {
+        for ( auto & arena : arenas ) {
+            delete [] arena.runs;
+            das_aligned_free16(arena.memory);
+        }
+    }
+
+    void SizeClassModel::newArena() {
+        uint32_t count;
+        if ( arenas.empty() ) {
+            if ( !initialSize ) {
+                initialSize = default_initial_size;
+            }
+            count = (initialSize + DAS_SIZE_CLASS_PAGE_SIZE - 1) >> DAS_SIZE_CLASS_PAGE_SHIFT;
+        } else {
+            count = arenas.back().count;
+            count = customGrow ? uint32_t(customGrow(count)) : count * 2;
+        }
+        count = das::max(count, 1u);
+        Arena arena;
+        arena.count = count;
+        arena.memory = das_aligned_alloc16(size_t(count + 1) * DAS_SIZE_CLASS_PAGE_SIZE);
+        arena.runs = new SizeClassRun[count];
+        arena.base = (char *) ((uintptr_t(arena.memory) + DAS_SIZE_CLASS_PAGE_SIZE - 1) & ~uintptr_t(DAS_SIZE_CLASS_PAGE_SIZE - 1));
+        for ( uint32_t i=0; i!=count; ++i ) {
+            arena.runs[i].data = arena.base + size_t(i) * DAS_SIZE_CLASS_PAGE_SIZE;
+        }
+        for ( uint32_t i=count; i!=0; --i ) {   // so that lower pages are used first
+            freeRuns.push_back(arena.runs + i - 1);
+        }
+        arenas.push_back(arena);
+    }
+
+    SizeClassRun * SizeClassModel::newRun ( uint32_t si ) {
+        if ( freeRuns.empty() ) newArena();
+        auto run = freeRuns.back();
+        freeRuns.pop_back();
+        run->init(run->data, si, classSize(si));
+        run->nextPartial = partial[si];
+        run->inPartial = true;
+        partial[si] = run;
+        return run;
+    }
+
+    void SizeClassModel::beforeGC() {
+        for ( auto & arena : arenas ) {
+            for ( uint32_t i=0; i!=arena.count; ++i ) {
+                auto run = arena.runs + i;
+                memset(run->gc_bits, 0, sizeof(run->gc_bits));
+                run->gc_allocated = 0;
+            }
+        }
+    }
+
+    void SizeClassModel::sweep() {
+        // marked slots become allocated, everything else goes back to the free list. empty runs go back to the page pool
+        totalAllocated = 0;
+        freeRuns.clear();
+        for ( uint32_t si=0; si!=DAS_SIZE_CLASS_COUNT; ++si ) {
+            partial[si] = nullptr;
+        }
+        for ( auto ita = arenas.rbegin(); ita!=arenas.rend(); ++ita ) {
+            for ( uint32_t i=ita->count; i!=0; --i ) {
+                auto run = ita->runs + i - 1;
+                if ( !run->size || !run->gc_allocated ) {
+#if DAS_SANITIZER
+                    if ( run->size ) memset(run->data, 0xcd, DAS_SIZE_CLASS_PAGE_SIZE);
+#endif
+                    run->size = 0;
+                    run->clear();
+                    freeRuns.push_back(run);
+                    continue;
+                }
+                memcpy(run->bits, run->gc_bits, sizeof(run->bits));
+                run->allocated = run->gc_allocated;
+                run->freeList = nullptr;
+                for ( uint32_t idx=run->bump; idx!=0; --idx ) {     // so that free list starts at the lowest slot
+                    uint32_t j = idx - 1;
+                    if ( !(run->bits[j>>5] & (1u<<(j&31))) ) {
+                        char * ptr = run->data + j * run->size;
+#if DAS_SANITIZER
+                        memset(ptr, 0xcd, run->size);
+#endif
+                        *(char **)ptr = run->freeList;
+                        run->freeList = ptr;
+                    }
+                }
+                totalAllocated += uint64_t(run->allocated) * run->size;
+                run->inPartial = run->hasRoom();
+                if ( run->inPartial ) {
+                    run->nextPartial = partial[run->sizeClass];
+                    partial[run->sizeClass] = run;
+                } else {
+                    run->nextPartial = nullptr;
+                }
+            }
+        }
+    }
+
+    void SizeClassModel::reset() {
+        totalAllocated = 0;
+        freeRuns.clear();
+        for ( uint32_t si=0; si!=DAS_SIZE_CLASS_COUNT; ++si ) {
+            partial[si] = nullptr;
+        }
+        for ( auto ita = arenas.rbegin(); ita!=arenas.rend(); ++ita ) {
+            for ( uint32_t i=ita->count; i!=0; --i ) {
+                auto run = ita->runs + i - 1;
+                run->size = 0;
+                run->clear();
+                freeRuns.push_back(run);
+            }
+        }
+    }
+
+    void SizeClassModel::shrink() {
+        // arenas can only go back to the OS all at once
+        if ( totalAllocated ) return;
+        for ( auto & arena : arenas ) {
+            delete [] arena.runs;
+            das_aligned_free16(arena.memory);
+        }
+        arenas.clear();
+        freeRuns.clear();
+        for ( uint32_t si=0; si!=DAS_SIZE_CLASS_COUNT; ++si ) {
+            partial[si] = nullptr;
+        }
+    }
+
+    uint32_t SizeClassModel::depth() const {
+        uint32_t counts[DAS_SIZE_CLASS_COUNT];
+        memset(counts, 0, sizeof(counts));
+        uint32_t d = 0;
+        for ( const auto & arena : arenas ) {
+            for ( uint32_t i=0; i!=arena.count; ++i ) {
+                auto run = arena.runs + i;
+                if ( run->size ) d = das::max(d, ++counts[run->sizeClass]);
+            }
+        }
+        return d;
+    }
+
+    uint64_t SizeClassModel::totalAlignedMemoryAllocated() const {
+        uint64_t mem = 0;
+        for ( const auto & arena : arenas ) {
+            mem += uint64_t(arena.count + 1) * DAS_SIZE_CLASS_PAGE_SIZE + uint64_t(arena.count) * sizeof(SizeClassRun);
+        }
+        return mem;
+    }
+
     char * LinearChunkAllocator::reallocate ( char * ptr, uint32_t size, uint32_t nsize ) {
         if ( !ptr ) return allocate(nsize);
         size = (size + alignMask) & ~alignMask;
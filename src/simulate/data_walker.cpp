@@ -199,6 +199,7 @@ namespace das {
         } else if ( info->type==Type::tTable ) {
             auto tab = (Table *) pa;
             if ( canVisitTable(pa,info) ) {
+                if ( tab->resizeData ) table_finish_resize(context, *tab, nullptr);
                 beforeTable(tab, info);
                 if ( cancel() ) return;
                 walk_table(tab, info);
@@ -856,4 +856,13 @@ namespace das
             fp.second->freeSourceData();
         }
     }
+
+    vector<string> FileAccess::getFileNames () const {
+        vector<string> names;
+        names.reserve(files.size());
+        for ( auto & fp : files ) {
+            if ( fp.second ) names.push_back(fp.first);
+        }
+        return names;
+    }
 }
@@ -57,6 +57,23 @@ namespace das {
         return true;
     }
 
+    static bool markBigAtomic ( MemoryModel & model, char * ptr ) {
+        auto it = model.bigStuff.find(ptr);     // nothing is allocated during mark, so concurrent lookups are fine
+        if ( it != model.bigStuff.end() ) {
+            return das_atomic_mark_bit(&it->second, DAS_PAGE_GC_MASK);
+        }
+        return false;
+    }
+
+    bool PersistentHeapAllocator::markAtomic ( char * ptr, uint32_t len ) {
+        auto size = (len + 15) & ~15; // model.alignMask
+        if ( size <= model.maxShoeAllocation ) {
+            return model.shoe.markAtomic(ptr,size);
+        } else {
+            return markBigAtomic(model, ptr);
+        }
+    }
+
     bool PersistentHeapAllocator::mark ( char * ptr, uint32_t len ) {
         auto size = (len + 15) & ~15; // model.alignMask
         if ( size <= model.maxShoeAllocation ) {
@@ -161,6 +178,146 @@ namespace das {
     int32_t PersistentHeapAllocator::getInitialSize() const { return model.initialSize; }
     void PersistentHeapAllocator::setGrowFunction ( CustomGrowFunction && fun ) { model.customGrow = fun; };
 
+    SizeClassHeapAllocator::SizeClassHeapAllocator() {
+        big.maxShoeAllocation = 0;
+    }
+
+    char * SizeClassHeapAllocator::allocateSlot ( uint32_t size ) {
+        if ( !size ) return nullptr;
+        return isSmall(size) ? small.allocate(size) : big.allocate(size);
+    }
+
+    void SizeClassHeapAllocator::freeSlot ( char * ptr, uint32_t size ) {
+        if ( !size ) return;
+        if ( isSmall(size) ) small.free(ptr, size);
+        else big.free(ptr, size);
+    }
+
+    char * SizeClassHeapAllocator::impl_allocate ( uint32_t size ) {
+        if ( limit==0 || bytesAllocated()+size<=limit ) {
+            totalAllocations ++;
+            totalBytesAllocated += size;
+            return allocateSlot(size);
+        } else {
+            return nullptr;
+        }
+    }
+
+    void SizeClassHeapAllocator::impl_free ( char * ptr, uint32_t size ) {
+        totalBytesDeleted += size;
+        freeSlot(ptr, size);
+    }
+
+    char * SizeClassHeapAllocator::impl_reallocate ( char * ptr, uint32_t oldSize, uint32_t newSize ) {
+        if ( limit==0 || bytesAllocated()+newSize-oldSize<=limit ) {
+            totalAllocations ++;
+            totalBytesAllocated += newSize-oldSize;
+            if ( !ptr ) return allocateSlot(newSize);
+            if ( oldSize && newSize && isSmall(oldSize) && isSmall(newSize)
+                    && SizeClassModel::sizeClass(oldSize)==SizeClassModel::sizeClass(newSize) ) {
+                return ptr;     // same slot fits both
+            }
+            if ( !isSmall(oldSize) && !isSmall(newSize) ) {
+                return big.reallocate(ptr, oldSize, newSize);
+            }
+            char * nptr = allocateSlot(newSize);
+            if ( nptr ) memcpy(nptr, ptr, das::min(oldSize, newSize));
+            freeSlot(ptr, oldSize);
+            return nptr;
+        } else {
+            return nullptr;
+        }
+    }
+
+    int SizeClassHeapAllocator::depth() const { return int(small.depth()); }
+    uint64_t SizeClassHeapAllocator::bytesAllocated() const { return small.bytesAllocated() + big.bytesAllocated(); }
+    uint64_t SizeClassHeapAllocator::totalAlignedMemoryAllocated() const { return small.totalAlignedMemoryAllocated() + big.totalAlignedMemoryAllocated(); }
+    void SizeClassHeapAllocator::reset() { small.reset(); big.reset(); }
+    void SizeClassHeapAllocator::shrink() { small.shrink(); big.shrink(); }
+
+    void SizeClassHeapAllocator::report() {
+        LOG tout(LogLevel::debug);
+        uint32_t runs[DAS_SIZE_CLASS_COUNT], slots[DAS_SIZE_CLASS_COUNT];
+        memset(runs, 0, sizeof(runs));
+        memset(slots, 0, sizeof(slots));
+        for ( const auto & arena : small.arenas ) {
+            for ( uint32_t i=0; i!=arena.count; ++i ) {
+                auto run = arena.runs + i;
+                if ( run->size ) {
+                    runs[run->sizeClass] ++;
+                    slots[run->sizeClass] += run->allocated;
+                }
+            }
+        }
+        for ( uint32_t si=0; si!=DAS_SIZE_CLASS_COUNT; ++si ) {
+            if ( runs[si] ) {
+                tout << "size class " << SizeClassModel::classSize(si) << ", " << runs[si] << " runs, "
+                    << slots[si] << " allocated\n";
+            }
+        }
+        if ( !big.bigStuff.empty() ) {
+            tout << "big stuff:\n\tsize\tpointer\n";
+            for ( const auto & it : big.bigStuff ) {
+                tout << "\t" << it.second << "\t0x" << HEX << intptr_t(it.first) << DEC << "\n";
+            }
+        }
+    }
+
+    bool SizeClassHeapAllocator::mark() {
+        small.beforeGC();
+        return true;
+    }
+
+    bool SizeClassHeapAllocator::mark ( char * ptr, uint32_t len ) {
+        if ( isSmall(len) ) {
+            return small.mark(ptr);
+        } else {
+            auto it = big.bigStuff.find(ptr);
+            if ( it != big.bigStuff.end() ) {
+                bool marked = it->second & DAS_PAGE_GC_MASK;
+                it->second |= DAS_PAGE_GC_MASK;
+                return !marked;
+            }
+        }
+        return false;
+    }
+
+    bool SizeClassHeapAllocator::markAtomic ( char * ptr, uint32_t len ) {
+        if ( isSmall(len) ) {
+            return small.markAtomic(ptr);
+        } else {
+            return markBigAtomic(big, ptr);
+        }
+    }
+
+    void SizeClassHeapAllocator::sweep() {
+        small.sweep();
+        big.sweep();
+    }
+
+    bool SizeClassHeapAllocator::isOwnPtr ( char * ptr, uint32_t size ) {
+        return isSmall(size) ? small.isOwnPtr(ptr) : big.isOwnPtr(ptr,size);
+    }
+
+    bool SizeClassHeapAllocator::isValidPtr ( char * ptr, uint32_t size ) {
+        return isSmall(size) ? small.isAllocatedPtr(ptr) : big.isAllocatedPtr(ptr,size);
+    }
+
+    void SizeClassHeapAllocator::setInitialSize ( uint32_t size ) {
+        small.initialSize = size;
+        big.setInitialSize(size);
+    }
+
+    int32_t SizeClassHeapAllocator::getInitialSize() const { return small.initialSize; }
+    void SizeClassHeapAllocator::setGrowFunction ( CustomGrowFunction && fun ) { small.customGrow = fun; }
+
+    void SizeClassHeapAllocator::setTrackAllocations ( bool on ) {
+        AnyHeapAllocator::setTrackAllocations(on);
+        big.setTrackAllocations(on);
+        big.maxShoeAllocation = 0;
+        maxSmallAllocation = on ? 0u : uint32_t(DAS_MAX_SIZE_CLASS_ALLOCATION);  // tracking is done by big stuff
+    }
+
     PersistentStringAllocator::PersistentStringAllocator() { model.alignMask = 3; }
     void PersistentStringAllocator::forEachString ( const callable<void (const char *)> & fn ) {
         for ( uint32_t si=0; si!=DAS_MAX_SHOE_CUNKS; ++si ) {
@@ -371,6 +528,15 @@ namespace das {
         return false;
     }
 
+    bool PersistentStringAllocator::markAtomic ( char * ptr, uint32_t len ) {
+        auto size = (len + 15) & ~15; // model.alignMask
+        if (size <= model.maxShoeAllocation) {
+            return model.shoe.markAtomic(ptr,len);
+        } else {
+            return markBigAtomic(model, ptr);
+        }
+    }
+
     bool PersistentStringAllocator::mark() {
         model.shoe.beforeGC();
         return true;
@@ -202,7 +202,9 @@ namespace das {
             } else if ( embed ) {
                 ss << value;
             } else {
-                ss << "\"" << escapeString(value ? value : "",false) << "\"";
+                ss << "\"";
+                if ( value ) escapeString(ss, value, strlen(value), false);
+                ss << "\"";
             }
         }
         virtual void Double ( double & value ) override {
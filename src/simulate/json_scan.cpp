@@ -4,15 +4,20 @@
 #include "daScript/simulate/debug_info.h"
 #include "daScript/simulate/aot_builtin.h"
 #include "daScript/misc/arraytype.h"
+#include "daScript/misc/byte_scan.h"
 #include "daScript/simulate/runtime_table.h"
 #include "daScript/ast/ast.h"
 
+#include <fast_float/fast_float.h>
+
 namespace das {
 
     // ---- TypeInfo-driven single-pass JSON scanner ----
     // No intermediate DOM. The JSON cursor and TypeInfo drive parsing together.
     // At each point we know what type we expect, parse the JSON token directly
     // into the target memory, and advance the cursor.
+    // Whitespace and string bodies are consumed 16 bytes at a time (see misc/byte_scan.h),
+    // numbers are parsed in place with fast_float.
 
     struct JsonScanner {
         const char * cur;
@@ -26,8 +31,7 @@ namespace das {
         // ---- whitespace & helpers ----
 
         void skipWS() {
-            while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r'))
-                cur++;
+            cur = skip_json_ws(cur, end);
         }
 
         bool expect(char ch) {
@@ -61,9 +65,12 @@ namespace das {
             if (cur >= end || *cur != '"') return false;
             cur++;
             while (cur < end) {
+                cur = scan_quote_or_backslash(cur, end);
+                if (cur >= end) return false;
                 char ch = *cur++;
                 if (ch == '"') return true;
-                if (ch == '\\') { if (cur >= end) return false; cur++; }
+                if (cur >= end) return false;
+                cur++;
             }
             return false;
         }
@@ -121,6 +128,11 @@ namespace das {
             cur++;
             out.clear();
             while (cur < end) {
+                // copy the run of plain characters in one go
+                const char * run = scan_quote_or_backslash(cur, end);
+                out.append(cur, run - cur);
+                cur = run;
+                if (cur >= end) return false;
                 char ch = *cur++;
                 if (ch == '"') return true;
                 if (ch == '\\') {
@@ -205,8 +217,12 @@ namespace das {
                 out = int64_t(d);
                 return true;
             }
-            string numStr(start, cur);
-            out = atoll(numStr.c_str());
+            auto res = fast_float::from_chars(start, cur, out);
+            if (res.ec != std::errc()) {
+                // out of int64 range, keep atoll saturation
+                string numStr(start, cur);
+                out = atoll(numStr.c_str());
+            }
             return true;
         }
 
@@ -226,8 +242,11 @@ namespace das {
                 if (cur < end && (*cur == '+' || *cur == '-')) cur++;
                 while (cur < end && *cur >= '0' && *cur <= '9') cur++;
             }
-            string numStr(start, cur);
-            out = atof(numStr.c_str());
+            auto res = fast_float::from_chars(start, cur, out);
+            if (res.ec != std::errc()) {
+                string numStr(start, cur);
+                out = atof(numStr.c_str());
+            }
             return true;
         }
 
@@ -838,4 +857,124 @@ namespace das {
         JsonScanner scanner(json, jsonLen, ctx, at);
         return scanner.scanValue(dst, info);
     }
+
+    // ---- Streaming: split chunked input into top-level values ----
+    // A top-level array is unwrapped into its elements, otherwise values simply
+    // follow each other (JSON lines). Only the current element is buffered, so memory
+    // does not depend on the size of the document. State survives between chunks.
+
+    struct JsonStreamSplitter {
+        enum class Mode { unknown, array, values };
+        Mode    mode = Mode::unknown;
+        int32_t depth = 0;
+        bool    inString = false;
+        bool    escape = false;
+        bool    inScalar = false;       // number, true, false, null
+        bool    needComma = false;      // array mode: element is done, expecting , or ]
+        bool    afterComma = false;     // array mode: expecting element
+        bool    closed = false;         // array mode: after ]
+        string  elem;
+
+        static bool isWS(char ch) { return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r'; }
+
+        template <typename EmitFn>
+        bool feed(const char * data, size_t size, EmitFn && emit) {
+            const char * p = data;
+            const char * end = data + size;
+            const char * start = (inString || inScalar || depth) ? p : nullptr;
+            auto done = [&](const char * upto) {
+                elem.append(start, upto - start);
+                emit(elem);
+                elem.clear();
+                start = nullptr;
+                needComma = mode == Mode::array;
+            };
+            while (p < end) {
+                char ch = *p;
+                if (inString) {
+                    p++;
+                    if (escape) { escape = false; continue; }
+                    if (ch == '\\') { escape = true; continue; }
+                    if (ch == '"') {
+                        inString = false;
+                        if (depth == 0) done(p);
+                    }
+                    continue;
+                }
+                if (inScalar) {
+                    if (!isWS(ch) && ch != ',' && ch != ']' && ch != '}') { p++; continue; }
+                    inScalar = false;
+                    done(p);        // delimiter is handled below, as part of the top level
+                }
+                if (depth) {
+                    p++;
+                    if (ch == '"') inString = true;
+                    else if (ch == '{' || ch == '[') depth++;
+                    else if (ch == '}' || ch == ']') { if (--depth == 0) done(p); }
+                    continue;
+                }
+                // between top-level values
+                p++;
+                if (isWS(ch)) continue;
+                if (closed) return false;
+                if (mode == Mode::unknown) {
+                    if (ch == '[') { mode = Mode::array; continue; }
+                    mode = Mode::values;
+                }
+                if (mode == Mode::array) {
+                    if (ch == ']') {
+                        if (afterComma) return false;
+                        closed = true;
+                        continue;
+                    }
+                    if (ch == ',') {
+                        if (!needComma) return false;
+                        needComma = false;
+                        afterComma = true;
+                        continue;
+                    }
+                    if (needComma) return false;
+                    afterComma = false;
+                }
+                start = p - 1;
+                if (ch == '"') inString = true;
+                else if (ch == '{' || ch == '[') depth = 1;
+                else if (ch == '}' || ch == ']' || ch == ',') return false;
+                else inScalar = true;
+            }
+            if (start) elem.append(start, end - start);
+            return true;
+        }
+
+        template <typename EmitFn>
+        bool finish(EmitFn && emit) {
+            if (inScalar) {
+                inScalar = false;
+                emit(elem);
+                elem.clear();
+                needComma = mode == Mode::array;
+            }
+            if (inString || depth) return false;
+            return mode != Mode::array || closed;
+        }
+    };
+
+    bool builtin_json_stream ( const TBlock<int32_t,TTemporary<TArray<uint8_t>>> & reader, const TBlock<void,TTemporary<const char *>> & blk, Context * context, LineInfoArg * at ) {
+        JsonStreamSplitter splitter;
+        vector<char> buffer(64 * 1024);
+        Array chunk;
+        vec4f rargs[1], bargs[1];
+        auto emit = [&](const string & elem) {
+            bargs[0] = cast<const char *>::from(elem.c_str());
+            context->invoke(blk, bargs, nullptr, at);
+        };
+        while (true) {
+            array_mark_locked(chunk, buffer.data(), uint32_t(buffer.size()));
+            rargs[0] = cast<Array *>::from(&chunk);
+            int32_t bytes = cast<int32_t>::to(context->invoke(reader, rargs, nullptr, at));
+            if (bytes <= 0) break;
+            if (!splitter.feed(buffer.data(), min(size_t(bytes), buffer.size()), emit)) return false;
+        }
+        return splitter.finish(emit);
+    }
 }
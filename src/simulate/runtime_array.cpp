@@ -70,6 +70,7 @@ namespace das
             newData = (char *)context.allocate(newCapacity*stride, at);
             if ( newData && arr.data ) {
                 memcpy(newData, arr.data, arr.size*stride);
+                context.retireStorage(arr.data, arr.capacity*stride);
             }
         } else {
             newData = (char *)context.reallocate(arr.data, arr.capacity*stride, newCapacity*stride, at);
@@ -4,6 +4,8 @@
 
 #include "misc/include_fmt.h"
 
+#include <chrono>
+
 extern "C" int64_t ref_time_ticks ();
 extern "C" int get_time_usec (int64_t reft);
 
@@ -26,5 +28,126 @@ namespace das
         }
         return (float) tSec;
     }
+
+    // sampling profiler
+
+    SamplingProfiler::SamplingProfiler ( Context * ctx, uint32_t intervalUsec )
+        : context(ctx), interval(das::max(intervalUsec, 10u)) {
+        watcher = thread([this](){ watch(); });
+    }
+
+    SamplingProfiler::~SamplingProfiler() {
+        stop();
+    }
+
+    void SamplingProfiler::stop() {
+        {
+            lock_guard<mutex> guard(lock);
+            done = true;
+        }
+        wakeUp.notify_all();
+        if ( watcher.joinable() ) watcher.join();
+        context->sampleRequest = false;
+    }
+
+    void SamplingProfiler::watch() {
+        unique_lock<mutex> guard(lock);
+        while ( !done ) {
+            if ( wakeUp.wait_for(guard, chrono::microseconds(interval), [&](){ return done; }) ) break;
+            context->sampleRequest = true;
+        }
+    }
+
+    void SamplingProfiler::sample ( Context & ctx ) {
+#if DAS_ENABLE_STACK_WALK
+        frames.clear();
+        char * sp = ctx.stack.ap();
+        while ( sp < ctx.stack.top() ) {
+            Prologue * pp = (Prologue *) sp;
+            FuncInfo * info = nullptr;
+            if ( pp->info ) {
+                intptr_t iblock = intptr_t(pp->block);
+                info = (iblock & 1) ? ((Block *)(iblock & ~1))->info : pp->info;
+                if ( !info ) break;
+            }
+            uint32_t incr = info ? info->stackSize : uint32_t(pp->stackSize);
+            if ( incr >= ctx.stack.size() || incr<sizeof(Prologue) ) break;
+            if ( info ) {
+                frames.push_back({info, SampleFrame::interpreted});
+            } else {
+                frames.push_back({pp->fileName, pp->is_jit ? SampleFrame::jit : SampleFrame::aot});
+            }
+            sp += incr;
+        }
+        if ( frames.empty() ) return;
+        reverse(frames.begin(), frames.end());
+        lock_guard<mutex> guard(lock);
+        stacks[frames] ++;
+        samples ++;
+#else
+        (void)ctx;
+#endif
+    }
+
+    void SamplingProfiler::report ( TextWriter & tw ) const {
+        lock_guard<mutex> guard(lock);
+        vector<string> names;
+        for ( const auto & st : stacks ) {
+            names.clear();
+            uint32_t prevKind = SampleFrame::aot;
+            for ( const auto & f : st.first ) {
+                string name;
+                if ( f.kind==SampleFrame::interpreted ) {
+                    name = ((FuncInfo *)f.key)->name;
+                } else {
+                    name = f.key ? (const char *)f.key : "?";
+                    if ( f.kind==SampleFrame::aot ) {
+                        // AOT prologue is 'name file:line'
+                        auto space = name.find(' ');
+                        if ( space!=string::npos ) name.resize(space);
+                    }
+                }
+                if ( f.kind==SampleFrame::jit ) {
+                    // interpreted call into JIT compiled function is two frames of the same function
+                    if ( prevKind==SampleFrame::interpreted && !names.empty() && names.back()==name ) names.pop_back();
+                    name += "_[j]";
+                }
+                names.push_back(name);
+                prevKind = f.kind;
+            }
+            for ( size_t i=0, is=names.size(); i!=is; ++i ) {
+                if ( i ) tw << ";";
+                tw << names[i];
+            }
+            tw << " " << st.second << "\n";
+        }
+    }
+
+    void Context::startSampling ( uint32_t intervalUsec ) {
+        stopSampling();
+        if ( sampler ) {
+            delete sampler;
+        }
+        sampler = new SamplingProfiler(this, intervalUsec);
+    }
+
+    void Context::stopSampling() {
+        if ( sampler ) {
+            sampler->stop();
+        }
+    }
+
+    uint64_t Context::reportSamples ( TextWriter & tw ) const {
+        if ( !sampler ) return 0;
+        sampler->report(tw);
+        return sampler->totalSamples();
+    }
+
+    void Context::takeProfileSample() {
+        sampleRequest = false;
+        if ( sampler ) {
+            sampler->sample(*this);
+        }
+    }
 }
 
@@ -8,6 +8,7 @@
 #include "daScript/simulate/runtime_string_delete.h"
 #include "daScript/simulate/simulate_nodes.h"
 #include "daScript/simulate/sim_policy.h"
+#include "daScript/misc/byte_scan.h"
 #include "misc/include_fmt.h"
 
 namespace das
@@ -419,39 +420,50 @@ namespace das
         return result;
     }
 
-    string escapeString ( const string & input, bool das_escape ) {
-        const char* str = input.c_str();
-        const char* strEnd = str + input.length();
-        string result;
-        result.reserve(input.size());
+    template <typename TT>
+    static void escapeStringTo ( TT & result, const char * str, const char * strEnd, bool das_escape ) {
         for( ; str < strEnd; ++str ) {
+            // runs of characters which need no escaping are appended as is
+            const char * run = scan_escape(str, strEnd, das_escape);
+            if ( run != str ) {
+                result.append(str, int(run - str));
+                str = run;
+                if ( str == strEnd ) break;
+            }
             auto ch = uint8_t(*str);
             switch ( ch ) {
-                case '\"':  result.append("\\\"");  break;
-                case '\\':  result.append("\\\\");  break;
-                case '\b':  result.append("\\b");   break;
-                case '\v':  result.append("\\v");   break;
-                case '\f':  result.append("\\f");   break;
-                case '\n':  result.append("\\n");   break;
-                case '\r':  result.append("\\r");   break;
-                case '\t':  result.append("\\t");   break;
-                case '{':   if (das_escape) result.append("\\{"); else result.append("{");  break;
-                case '}':   if (das_escape) result.append("\\}"); else result.append("}");  break;
-                default:
-                    if ( ch <= 0x1f ) {
-                        result.append("\\u00");
+                case '\"':  result.append("\\\"", 2);  break;
+                case '\\':  result.append("\\\\", 2);  break;
+                case '\b':  result.append("\\b", 2);   break;
+                case '\v':  result.append("\\v", 2);   break;
+                case '\f':  result.append("\\f", 2);   break;
+                case '\n':  result.append("\\n", 2);   break;
+                case '\r':  result.append("\\r", 2);   break;
+                case '\t':  result.append("\\t", 2);   break;
+                case '{':   if (das_escape) result.append("\\{", 2); else result.append("{", 1);  break;
+                case '}':   if (das_escape) result.append("\\}", 2); else result.append("}", 1);  break;
+                default: {
+                        // scan_escape only stops on the cases above and control characters
                         const char tohex[] = "0123456789abcdef";
-                        result.append(1,tohex[ch>>4]);
-                        result.append(1,tohex[ch&15]);
-                    } else {
-                        result.append(1, ch);
+                        char hex[6] = { '\\', 'u', '0', '0', tohex[ch>>4], tohex[ch&15] };
+                        result.append(hex, 6);
                     }
                     break;
             }
         }
+    }
+
+    string escapeString ( const string & input, bool das_escape ) {
+        string result;
+        result.reserve(input.size());
+        escapeStringTo(result, input.c_str(), input.c_str() + input.length(), das_escape);
         return result;
     }
 
+    void escapeString ( StringWriter & ss, const char * str, size_t len, bool das_escape ) {
+        escapeStringTo(ss, str, str + len, das_escape);
+    }
+
     static string getFewLines ( const char* st, uint32_t stlen, int ROW, int COL, int /*LROW*/, int LCOL, int TAB ) {
         TextWriter text;
         int col=0, row=1;
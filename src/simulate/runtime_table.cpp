@@ -54,8 +54,57 @@ namespace das
         }
     }
 
+    // incremental resize
+
+    static void table_resize_sizes ( const Table & tab, uint32_t & valueTypeSize, uint32_t & keyTypeSize ) {
+        valueTypeSize = uint32_t(tab.keys - tab.data) / tab.capacity;
+        keyTypeSize = uint32_t((char *)tab.hashes - tab.keys) / tab.capacity;
+    }
+
+    static void table_resize_free ( Context * context, Table & tab, uint32_t valueTypeSize, uint32_t keyTypeSize, LineInfo * at ) {
+        // without context (some data walkers) previous storage is left to the heap
+        if ( context ) {
+            uint32_t oldSize = tab.resizeCapacity*(valueTypeSize + keyTypeSize + sizeof(TableHashKey));
+            if ( context->verySafeContext ) {
+                context->retireStorage(tab.resizeData, oldSize);
+            } else {
+                context->free(tab.resizeData, oldSize, at);
+            }
+        }
+        tab.resizeData = nullptr;
+        tab.resizeCapacity = 0;
+        tab.resizeIndex = 0;
+    }
+
+    void table_resize_step ( Context * context, Table & tab, uint32_t valueTypeSize, uint32_t keyTypeSize, uint32_t budget, LineInfo * at ) {
+        DAS_ASSERT(tab.resizeData && !tab.isLocked());
+        auto oldHashes = table_resize_hashes(tab, valueTypeSize, keyTypeSize);
+        uint32_t last = (tab.resizeCapacity - tab.resizeIndex) > budget ? tab.resizeIndex + budget : tab.resizeCapacity;
+        for ( uint32_t i=tab.resizeIndex; i!=last; ++i ) {
+            if ( oldHashes[i] > HASH_KILLED64 ) {
+                table_resize_move(tab, i, valueTypeSize, keyTypeSize);
+            }
+        }
+        tab.resizeIndex = last;
+        if ( last==tab.resizeCapacity ) {
+            table_resize_free(context, tab, valueTypeSize, keyTypeSize, at);
+        }
+    }
+
+    void table_finish_resize ( Context * context, Table & tab, LineInfo * at ) {
+        if ( !tab.resizeData ) return;
+        uint32_t valueTypeSize, keyTypeSize;
+        table_resize_sizes(tab, valueTypeSize, keyTypeSize);
+        table_resize_step(context, tab, valueTypeSize, keyTypeSize, -1u, at);
+    }
+
     void table_clear ( Context & context, Table & arr, LineInfo * at ) {
         if ( arr.isLocked() ) context.throw_error_at(at, "can't clear locked table");
+        if ( arr.resizeData ) {
+            uint32_t valueTypeSize, keyTypeSize;
+            table_resize_sizes(arr, valueTypeSize, keyTypeSize);
+            table_resize_free(&context, arr, valueTypeSize, keyTypeSize, at);
+        }
         if ( arr.data ) {
             memset(arr.hashes, 0, arr.capacity*sizeof(TableHashKey));
             memset(arr.data, 0, arr.keys - arr.data);
@@ -65,6 +114,7 @@ namespace das
     }
 
     void table_lock ( Context & context, Table & arr, LineInfo * at ) {
+        if ( arr.resizeData ) table_finish_resize(&context, arr, at);   // locked table never has previous storage
         if ( arr.shared || arr.hopeless ) return;
         if ( arr.lock==0 ) {
             if ( arr.magic != 0 ) {
@@ -227,6 +277,7 @@ namespace das
         for ( uint32_t i=0, is=total; i!=is; ++i, pTable-- ) {
             if ( pTable->data ) {
                 if ( !pTable->isLocked() ) {
+                    if ( pTable->resizeData ) table_finish_resize(&context, *pTable, &debugInfo);
                     uint32_t oldSize = pTable->capacity*(vts_add_kts + sizeof(TableHashKey));
                     context.free(pTable->data, oldSize, &debugInfo);
                 } else {
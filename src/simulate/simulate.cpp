@@ -3,6 +3,7 @@
 #include "daScript/simulate/simulate.h"
 #include "daScript/simulate/simulate_nodes.h"
 #include "daScript/simulate/runtime_string.h"
+#include "daScript/simulate/runtime_profile.h"
 #include "daScript/simulate/debug_print.h"
 #include "daScript/misc/fpe.h"
 #include "daScript/misc/string_writer.h"
@@ -1015,10 +1016,16 @@ namespace das
 
     void Context::setup(int totalVars, uint32_t globalStringHeapSize, CodeOfPolicies policies, AnnotationArgumentList options) {
         verySafeContext = options.getBoolOption("very_safe_context",policies.very_safe_context);
+        incrementalTableResize = options.getBoolOption("incremental_table_resize",policies.incremental_table_resize);
+        parallelGcMark = options.getBoolOption("parallel_gc_mark",policies.parallel_gc_mark);
         breakOnException |= policies.debugger;
         gcEnabled = options.getBoolOption("gc", false);
         persistent = options.getBoolOption("persistent_heap", policies.persistent_heap);
-        if ( persistent ) {
+        sizeClassHeap = options.getBoolOption("size_class_heap", policies.size_class_heap);
+        if ( persistent && sizeClassHeap ) {
+            heap = make_unique<SizeClassHeapAllocator>();
+            stringHeap = make_unique<PersistentStringAllocator>();
+        } else if ( persistent ) {
             heap = make_unique<PersistentHeapAllocator>();
             stringHeap = make_unique<PersistentStringAllocator>();
         } else {
@@ -1175,6 +1182,132 @@ namespace das
         tabAdLookup = ctx.tabAdLookup;
     }
 
+    // hot patch
+
+    typedef vector<pair<StructInfo *,StructInfo *>> HotPatchVisited;
+
+    static bool isSameLayout ( TypeInfo * a, TypeInfo * b, HotPatchVisited & visited );
+
+    static bool isSameLayout ( StructInfo * a, StructInfo * b, HotPatchVisited & visited ) {
+        if ( a==b ) return true;
+        if ( !a || !b ) return false;
+        for ( auto & ab : visited ) {
+            if ( ab.first==a && ab.second==b ) return true;
+        }
+        visited.emplace_back(a, b);
+        if ( a->size!=b->size || a->count!=b->count || a->flags!=b->flags ) return false;
+        for ( uint32_t i=0; i!=a->count; ++i ) {
+            auto fa = a->fields[i];
+            auto fb = b->fields[i];
+            if ( fa->offset!=fb->offset || strcmp(fa->name, fb->name)!=0 ) return false;
+            if ( !isSameLayout(fa, fb, visited) ) return false;
+        }
+        return true;
+    }
+
+    static bool isSameLayout ( TypeInfo * a, TypeInfo * b, HotPatchVisited & visited ) {
+        if ( a==b ) return true;
+        if ( !a || !b ) return false;
+        if ( a->type!=b->type || a->size!=b->size || a->dimSize!=b->dimSize || a->argCount!=b->argCount ) return false;
+        for ( uint32_t i=0; i!=a->dimSize; ++i ) {
+            if ( a->dim[i]!=b->dim[i] ) return false;
+        }
+        if ( a->type==Type::tStructure && !isSameLayout(a->structType, b->structType, visited) ) return false;
+        if ( a->type==Type::tHandle && a->hash!=b->hash ) return false;
+        if ( !isSameLayout(a->firstType, b->firstType, visited) ) return false;
+        if ( !isSameLayout(a->secondType, b->secondType, visited) ) return false;
+        if ( (a->argTypes==nullptr)!=(b->argTypes==nullptr) ) return false;
+        for ( uint32_t i=0; a->argTypes && i!=a->argCount; ++i ) {
+            if ( !isSameLayout(a->argTypes[i], b->argTypes[i], visited) ) return false;
+        }
+        return true;
+    }
+
+    static void collectStructs ( TypeInfo * info, das_hash_map<string,StructInfo *> & structs ) {
+        if ( !info ) return;
+        if ( info->type==Type::tStructure && info->structType ) {
+            auto si = info->structType;
+            auto name = string(si->module_name ? si->module_name : "") + "::" + si->name;
+            if ( structs.find(name)!=structs.end() ) return;
+            structs[name] = si;
+            for ( uint32_t i=0; i!=si->count; ++i ) {
+                collectStructs(si->fields[i], structs);
+            }
+        }
+        collectStructs(info->firstType, structs);
+        collectStructs(info->secondType, structs);
+        for ( uint32_t i=0; info->argTypes && i!=info->argCount; ++i ) {
+            collectStructs(info->argTypes[i], structs);
+        }
+    }
+
+    int32_t Context::hotPatchFrom ( const shared_ptr<Context> & ctx, TextWriter * log ) {
+        auto fail = [&]( const string & reason ) -> int32_t {
+            if ( log ) *log << "can't hot patch, " << reason << "\n";
+            return -1;
+        };
+        if ( !ctx || ctx.get()==this ) return fail("there is no new context");
+        // same functions, in the same order
+        if ( totalFunctions!=ctx->totalFunctions ) return fail("functions were added or removed");
+        for ( int i=0; i!=totalFunctions; ++i ) {
+            if ( functions[i].mangledNameHash!=ctx->functions[i].mangledNameHash ) {
+                return fail(string("function '") + functions[i].mangledName + "' was added or removed");
+            }
+        }
+        // same global variables
+        if ( totalVariables!=ctx->totalVariables || globalsSize!=ctx->globalsSize || sharedSize!=ctx->sharedSize ) {
+            return fail("global variables were added or removed");
+        }
+        HotPatchVisited visited;
+        for ( int i=0; i!=totalVariables; ++i ) {
+            auto & ga = globalVariables[i];
+            auto & gb = ctx->globalVariables[i];
+            if ( ga.mangledNameHash!=gb.mangledNameHash || ga.offset!=gb.offset || ga.size!=gb.size || ga.flags!=gb.flags
+                    || !isSameLayout(ga.debugInfo, gb.debugInfo, visited) ) {
+                return fail(string("global variable '") + ga.name + "' changed");
+            }
+        }
+        // same layout of every structure both programs work with, since heap is full of them
+        auto collect = [&]( Context & c, das_hash_map<string,StructInfo *> & structs ) {
+            for ( int i=0; i!=c.totalVariables; ++i ) {
+                collectStructs(c.globalVariables[i].debugInfo, structs);
+            }
+            for ( int i=0; i!=c.totalFunctions; ++i ) {
+                auto fi = c.functions[i].debugInfo;
+                if ( !fi ) continue;
+                for ( uint32_t a=0; a!=fi->count; ++a ) collectStructs(fi->fields[a], structs);
+                collectStructs(fi->result, structs);
+                for ( uint32_t l=0; l!=fi->localCount; ++l ) collectStructs(fi->locals[l], structs);
+            }
+        };
+        das_hash_map<string,StructInfo *> structsA, structsB;
+        collect(*this, structsA);
+        collect(*ctx, structsB);
+        for ( auto & sa : structsA ) {
+            auto sb = structsB.find(sa.first);
+            if ( sb!=structsB.end() && !isSameLayout(sa.second, sb->second, visited) ) {
+                return fail("layout of structure '" + sa.first + "' changed");
+            }
+        }
+        // take over the code of changed functions. function pointers, lambdas, and classes
+        // keep pointing to the same SimFunction, so they pick up the new code too
+        int32_t patched = 0;
+        for ( int i=0; i!=totalFunctions; ++i ) {
+            auto & fa = functions[i];
+            auto & fb = ctx->functions[i];
+            if ( fa.code && fb.code && getSemanticHash(fa.code, this)==getSemanticHash(fb.code, ctx.get()) ) continue;
+            fa = fb;
+            // code of the earlier patches calls through the function tables of its own context
+            for ( auto & src : hotPatchSources ) {
+                src->functions[i] = fb;
+            }
+            if ( log ) *log << "hot patched " << fb.mangledName << "\n";
+            patched ++;
+        }
+        hotPatchSources.push_back(ctx);
+        return patched;
+    }
+
     void Context::freeGlobalsAndShared() {
         if ( globals && globalsOwner ) {
             das_aligned_free16(globals);
@@ -1221,7 +1354,10 @@ namespace das
         : stack(opts.stackSize ? opts.stackSize : ctx.stack.size()) {
         ref_count_magic = TRACK_PTR_CONTEXT;
         verySafeContext = ctx.verySafeContext;
+        incrementalTableResize = ctx.incrementalTableResize;
+        parallelGcMark = ctx.parallelGcMark;
         persistent = ctx.persistent;
+        sizeClassHeap = ctx.sizeClassHeap;
         gcEnabled = ctx.gcEnabled;
         code = ctx.code;
         constStringHeap = ctx.constStringHeap;
@@ -1231,7 +1367,10 @@ namespace das
         name = "clone of " + ctx.name;
         category.value = opts.category;
         ownStack = (ctx.stack.size() != 0);
-        if ( persistent ) {
+        if ( persistent && sizeClassHeap ) {
+            heap = make_unique<SizeClassHeapAllocator>();
+            stringHeap = make_unique<PersistentStringAllocator>();
+        } else if ( persistent ) {
             heap = make_unique<PersistentHeapAllocator>();
             stringHeap = make_unique<PersistentStringAllocator>();
         } else {
@@ -1277,26 +1416,45 @@ namespace das
         // now, make it good to go
         restart();
         if ( !failed ) {
-            if ( stack.size() > globalInitStackSize ) {
-                failed |= !runWithCatch([&]() {
-                    runInitScript();
-                });
-            } else {
-                auto ssz = max ( int(stack.size()), 16384 ) + globalInitStackSize;
-                StackAllocator init_stack(ssz);
-                SharedStackGuard init_guard(*this, init_stack);
-                failed |= !runWithCatch([&]() {
-                    runInitScript();
-                });
-            }
-            if ( failed ) {
-                to_err(&exceptionAt, getException());
-                clearException();
-            }
+            runInitScriptWithStack();
         }
         restart();
     }
 
+    bool Context::runInitScriptWithStack() {
+        if ( stack.size() > globalInitStackSize ) {
+            failed |= !runWithCatch([&]() {
+                runInitScript();
+            });
+        } else {
+            auto ssz = max ( int(stack.size()), 16384 ) + globalInitStackSize;
+            StackAllocator init_stack(ssz);
+            SharedStackGuard init_guard(*this, init_stack);
+            failed |= !runWithCatch([&]() {
+                runInitScript();
+            });
+        }
+        if ( failed ) {
+            to_err(&exceptionAt, getException());
+            clearException();
+        }
+        return !failed;
+    }
+
+    bool Context::resetForReuse() {
+        DAS_ASSERTF(insideContext==0,"can't reset locked context");
+        if ( failed ) return false;
+        // [finalize] functions see the state of the previous use
+        runShutdownScript();
+        shutdown = false;
+        restart();
+        gcRoots.clear();
+        restartHeaps();
+        runInitScriptWithStack();
+        restart();
+        return !failed;
+    }
+
     void Context::addGcRoot ( void * ptr, TypeInfo * type ) {
         gcRoots[ptr] = type;
     }
@@ -1306,6 +1464,10 @@ namespace das
     }
 
     Context::~Context() {
+        if ( sampler ) {
+            delete sampler;
+            sampler = nullptr;
+        }
         if ( !failed ) {
             on_debug_agent_mutex([&](){
                 // unregister
@@ -34,6 +34,7 @@ namespace das {
         }
         uint32_t valueTypeSize;
         uint32_t offset;
+        uint64_t constKeyHash;
     };
 
 #define IMPLEMENT_OP2_SET_NODE_ANY(INLINE,OPNAME,TYPE,CTYPE,COMPUTEL) \
@@ -44,7 +45,7 @@ namespace das {
             if ( tab->isLocked() ) context.throw_error_at(debugInfo, "can't insert to a locked table"); \
             auto key = EvalTT<CTYPE>::eval(context,r.subexpr); \
             TableHash<CTYPE> thh(&context,valueTypeSize); \
-            auto hfn = hash_function(context, key); \
+            auto hfn = constKeyHash ? constKeyHash : hash_function(context, key); \
             int index = thh.reserve(*tab, key, hfn, &debugInfo); \
             return tab->data + index * valueTypeSize + offset; \
         } \
@@ -59,7 +60,7 @@ namespace das {
             if ( tab->isLocked() ) context.throw_error_at(debugInfo, "can't insert to a locked table"); \
             auto key = *((CTYPE *)r.compute##COMPUTER(context)); \
             TableHash<CTYPE> thh(&context,valueTypeSize); \
-            auto hfn = hash_function(context, key); \
+            auto hfn = constKeyHash ? constKeyHash : hash_function(context, key); \
             int index = thh.reserve(*tab, key, hfn, &debugInfo); \
             return tab->data + index * valueTypeSize + offset; \
         } \
@@ -70,7 +71,8 @@ namespace das {
     auto rn = (SimNode_OpTableIndex *)result; \
     auto sn = (SimNode_TableIndex<int> *)node; \
     rn->valueTypeSize = sn->valueTypeSize; \
-    rn->offset = sn->offset;
+    rn->offset = sn->offset; \
+    rn->constKeyHash = sn->constKeyHash;
 
 #define FUSION_OP2_SUBEXPR_LEFT(CTYPE,node)     ((static_cast<SimNode_Table *>(node))->tabExpr)
 #define FUSION_OP2_SUBEXPR_RIGHT(CTYPE,node)    ((static_cast<SimNode_Table *>(node))->keyExpr)
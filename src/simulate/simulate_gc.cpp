@@ -4,6 +4,9 @@
 #include "daScript/simulate/simulate.h"
 #include "daScript/simulate/data_walker.h"
 #include "daScript/simulate/debug_print.h"
+#include "daScript/simulate/runtime_table.h"
+#include "daScript/misc/job_que.h"
+#include "daScript/misc/performance_time.h"
 
 namespace das
 {
@@ -129,11 +132,15 @@ namespace das
 
         virtual void walk_table ( Table * tab, TypeInfo * info ) override {
             if ( !canVisitTableData(info) ) return;
+            walk_table_slots(tab, info, 0, tab->capacity);
+        }
+
+        void walk_table_slots ( Table * tab, TypeInfo * info, uint32_t from, uint32_t to ) {
             int keySize = info->firstType->size;
             int valueSize = info->secondType->size;
             if (info->firstType->flags & gcFlags) {
                 if (info->secondType->flags & gcFlags) {
-                    for ( uint32_t i=0, is=tab->capacity; i!=is; ++i ) {
+                    for ( uint32_t i=from; i!=to; ++i ) {
                         if ( tab->hashes[i] > HASH_KILLED64 ) {
                             // key
                             char * key = tab->keys + i*keySize;
@@ -144,7 +151,7 @@ namespace das
                         }
                     }
                 } else {
-                    for ( uint32_t i=0, is=tab->capacity; i!=is; ++i ) {
+                    for ( uint32_t i=from; i!=to; ++i ) {
                         if ( tab->hashes[i] > HASH_KILLED64 ) {
                             // key
                             char * key = tab->keys + i*keySize;
@@ -153,7 +160,7 @@ namespace das
                     }
                 }
             } else {
-                for ( uint32_t i=0, is=tab->capacity; i!=is; ++i ) {
+                for ( uint32_t i=from; i!=to; ++i ) {
                     if ( tab->hashes[i] > HASH_KILLED64 ) {
                         // value
                         char * value = tab->data + i*valueSize;
@@ -189,6 +196,7 @@ namespace das
                         break;
                     case Type::tTable: {
                             auto tab = (Table *) pa;
+                            if ( tab->resizeData ) table_finish_resize(nullptr, *tab, nullptr);   // previous storage is left to the collector
                             beforeTable(tab, info);
                             walk_table(tab, info);
                             afterTable(tab, info);
@@ -728,6 +736,7 @@ namespace das
         das_set<char *>     failed;
         bool                markStringHeap = true;
         bool                validate = false;
+        bool                atomicMark = false;     // several walkers mark the same heap (parallel mark)
         void prepare() {
             currentRange.clear();
             gcFlags = TypeInfo::flag_heapGC;
@@ -751,6 +760,8 @@ namespace das
                             failed.insert(r.from);
                         }
                     }
+                } else if ( atomicMark ) {
+                    result = context->heap->markAtomic(r.from, ssize);
                 } else {
                     result = context->heap->mark(r.from, ssize);
                 }
@@ -850,11 +861,27 @@ namespace das
                         failed.insert(st);
                     }
                 }
+            } else if ( atomicMark ) {
+                context->stringHeap->markAtomic(st, len);
             } else {
                 context->stringHeap->mark(st, len);
             }
         }
 
+        // parallel mark can't finish incremental resize - the same table can be reachable from several walkers.
+        // previous storage is marked and walked as is, entries which were already moved out of it are killed
+        void walk_resize_storage ( Table * tab, TypeInfo * info ) {
+            uint32_t valueSize = info->secondType->size;
+            Table prev = *tab;
+            prev.data = tab->resizeData;
+            prev.keys = table_resize_keys(*tab, valueSize);
+            prev.hashes = table_resize_hashes(*tab, valueSize, info->firstType->size);
+            prev.capacity = tab->resizeCapacity;
+            beforeTable(&prev, info);
+            walk_table(&prev, info);
+            afterTable(&prev, info);
+        }
+
         virtual void beforeIterator ( Iterator * iter ) override {
             char * ptr = ((char *) iter) - 16;
             uint32_t size = *((uint32_t *)ptr);
@@ -885,6 +912,10 @@ namespace das
                         break;
                     case Type::tTable: {
                             auto tab = (Table *) pa;
+                            if ( tab->resizeData ) {
+                                if ( atomicMark ) walk_resize_storage(tab, info);
+                                else table_finish_resize(nullptr, *tab, nullptr);   // previous storage is left to the collector
+                            }
                             beforeTable(tab, info);
                             walk_table(tab, info);
                             afterTable(tab, info);
@@ -955,6 +986,92 @@ namespace das
         }
     };
 
+    extern mutex              g_jobQueMutex;
+    extern shared_ptr<JobQue> g_jobQue;
+
+    // parallel mark. gc roots and globals become tasks, large arrays and tables are split into chunks of elements.
+    // job que helpers and the collecting thread take tasks from the same list, so nobody waits for a job which never started
+    struct GcMarkTask {
+        char *      pa = nullptr;
+        TypeInfo *  ti = nullptr;       // nullptr for lambda roots
+        Table *     tab = nullptr;      // chunk of table slots
+        uint32_t    from = 0;           // chunk of array elements or table slots
+        uint32_t    to = 0;
+        PtrRange    range;              // data of the array or table, which was split into chunks. its already marked
+    };
+
+    struct GcParallelMark {
+        enum { chunkSize = 4096 };      // array elements or table slots per task
+        vector<GcMarkTask>  tasks;
+        atomic<uint32_t>    next{0};
+        atomic<int32_t>     inFlight{0};
+        atomic<uint32_t>    threads{0};
+        atomic<bool>        closed{false};
+        void addRoot ( GcMarkAnyHeap & walker, char * pa, TypeInfo * ti ) {
+            GcMarkTask task;
+            if ( ti && !(ti->flags & TypeInfo::flag_ref) && !ti->dimSize ) {
+                walker.prepare();
+                if ( ti->type==Type::tArray ) {
+                    auto arr = (Array *) pa;
+                    if ( arr->size>chunkSize && walker.canVisitArrayData(ti->firstType, arr->size) ) {
+                        task.range = PtrRange(arr->data, size_t(ti->firstType->size) * size_t(arr->capacity));
+                        walker.markAndPushRange(task.range);
+                        walker.popRange();
+                        task.pa = arr->data;
+                        task.ti = ti->firstType;
+                        for ( uint32_t i=0; i<arr->size; i+=chunkSize ) {
+                            task.from = i;
+                            task.to = min(i+uint32_t(chunkSize), arr->size);
+                            tasks.push_back(task);
+                        }
+                        return;
+                    }
+                } else if ( ti->type==Type::tTable ) {
+                    auto tab = (Table *) pa;
+                    if ( !tab->resizeData && tab->capacity>chunkSize && walker.canVisitTableData(ti) ) {
+                        task.range = PtrRange(tab->data, (ti->firstType->size+ti->secondType->size+sizeof(TableHashKey))*size_t(tab->capacity));
+                        walker.markAndPushRange(task.range);
+                        walker.popRange();
+                        task.tab = tab;
+                        task.ti = ti;
+                        for ( uint32_t i=0; i<tab->capacity; i+=chunkSize ) {
+                            task.from = i;
+                            task.to = min(i+uint32_t(chunkSize), tab->capacity);
+                            tasks.push_back(task);
+                        }
+                        return;
+                    }
+                }
+            }
+            task.pa = pa;
+            task.ti = ti;
+            tasks.push_back(task);
+        }
+        void markTask ( GcMarkAnyHeap & walker, const GcMarkTask & task ) {
+            walker.prepare();
+            if ( task.tab ) {
+                walker.currentRange = task.range;
+                walker.walk_table_slots(task.tab, task.ti, task.from, task.to);
+            } else if ( !task.range.empty() ) {
+                walker.currentRange = task.range;
+                walker.walk_array(task.pa + size_t(task.from)*task.ti->size, task.ti->size, task.to-task.from, task.ti);
+            } else if ( task.ti ) {
+                walker.walk(task.pa, task.ti);
+            } else {
+                Lambda lmb(task.pa);
+                walker.walk((char *)&lmb, &lambda_type_info);
+            }
+        }
+        uint32_t drain ( GcMarkAnyHeap & walker ) {
+            uint32_t count = 0;
+            for ( uint32_t index = next++; index<tasks.size(); index = next++ ) {
+                markTask(walker, tasks[index]);
+                count ++;
+            }
+            return count;
+        }
+    };
+
     struct GcGuard {
         GcGuard(Context * c) : ctx(c) { dapiOnBeforeGC(*ctx); }
         ~GcGuard() { dapiOnAfterGC(*ctx); }
@@ -963,8 +1080,12 @@ namespace das
 
     void Context::collectHeap ( LineInfo * at, bool sheap, bool validate ) {
         GcGuard guard(this);
+        auto t0 = ref_time_ticks();
         // clean up, so that all small allocations are marked as 'free'
         stringDisposeQue = nullptr;
+        // retired storage is swept, unless something still points to it
+        retiredStorage.clear();
+        retiredBytes = 0;
         // When allocation tracking is on, entries in MemoryModel::bigStuffComment
         // may point into stringHeap (e.g. tag_array/tag_table with a dynamic name)
         // and are not reachable as GC roots. Skipping stringHeap GC keeps those
@@ -978,31 +1099,79 @@ namespace das
         walker.markStringHeap = sheap;
         walker.context = this;
         walker.validate = validate;
-        // mark GC roots
-        foreach_gc_root([&](void * _pa, TypeInfo * ti) {
-            char * pa = (char *) _pa;
-            walker.prepare();
-            if ( ti ) {
-                walker.walk(pa, ti);
-            } else {
-                Lambda lmb(pa);
-                walker.walk((char *)&lmb, &lambda_type_info);
+        // parallel mark needs job que, and heaps which can mark from several threads at once
+        shared_ptr<JobQue> jobQue;
+        if ( parallelGcMark && !validate && heap->canMarkAtomic() && (!sheap || stringHeap->canMarkAtomic()) ) {
+            lock_guard<mutex> jqguard(g_jobQueMutex);
+            jobQue = g_jobQue;
+        }
+        uint32_t markThreads = 1, markTasks = 0;
+        if ( jobQue ) {
+            walker.atomicMark = true;
+            auto pm = make_shared<GcParallelMark>();
+            foreach_gc_root([&](void * pa, TypeInfo * ti) {
+                pm->addRoot(walker, (char *)pa, ti);
+            });
+            if ( sharedOwner ) {
+                for ( int i=0, is=totalVariables; i!=is; ++i ) {
+                    auto & pv = globalVariables[i];
+                    if ( !pv.shared ) continue;
+                    pm->addRoot(walker, shared + pv.offset, pv.debugInfo);
+                }
             }
-        });
-        // mark globals
-        if ( sharedOwner ) {
             for ( int i=0, is=totalVariables; i!=is; ++i ) {
                 auto & pv = globalVariables[i];
-                if ( !pv.shared ) continue;
+                if ( pv.shared ) continue;
+                pm->addRoot(walker, globals + pv.offset, pv.debugInfo);
+            }
+            markTasks = uint32_t(pm->tasks.size());
+            auto bound = daScriptEnvironment::getBound();
+            Context * ctx = this;
+            for ( int i=0, is=min(jobQue->getTotalHwJobs(), int(markTasks)-1); i<is; ++i ) {
+                jobQue->push([pm, bound, ctx, sheap]() {
+                    pm->inFlight ++;
+                    if ( !pm->closed ) {    // once closed, context may be gone
+                        daScriptEnvironment::setBound(bound);
+                        GcMarkAnyHeap helper;
+                        helper.markStringHeap = sheap;
+                        helper.context = ctx;
+                        helper.atomicMark = true;
+                        if ( pm->drain(helper) ) pm->threads ++;
+                    }
+                    pm->inFlight --;
+                }, 0, JobPriority::Default);
+            }
+            pm->drain(walker);
+            pm->closed = true;
+            while ( pm->inFlight ) this_thread::yield();
+            markThreads += pm->threads;
+        } else {
+            // mark GC roots
+            foreach_gc_root([&](void * _pa, TypeInfo * ti) {
+                char * pa = (char *) _pa;
                 walker.prepare();
-                walker.walk(shared + pv.offset, pv.debugInfo);
+                if ( ti ) {
+                    walker.walk(pa, ti);
+                } else {
+                    Lambda lmb(pa);
+                    walker.walk((char *)&lmb, &lambda_type_info);
+                }
+            });
+            // mark globals
+            if ( sharedOwner ) {
+                for ( int i=0, is=totalVariables; i!=is; ++i ) {
+                    auto & pv = globalVariables[i];
+                    if ( !pv.shared ) continue;
+                    walker.prepare();
+                    walker.walk(shared + pv.offset, pv.debugInfo);
+                }
+            }
+            for ( int i=0, is=totalVariables; i!=is; ++i ) {
+                auto & pv = globalVariables[i];
+                if ( pv.shared ) continue;
+                walker.prepare();
+                walker.walk(globals + pv.offset, pv.debugInfo);
             }
-        }
-        for ( int i=0, is=totalVariables; i!=is; ++i ) {
-            auto & pv = globalVariables[i];
-            if ( pv.shared ) continue;
-            walker.prepare();
-            walker.walk(globals + pv.offset, pv.debugInfo);
         }
         // mark stack
         char * sp = stack.ap();
@@ -1048,10 +1217,16 @@ namespace das
             lineAt = info ? pp->line : nullptr;
             sp += info ? info->stackSize : pp->stackSize;
         }
+        gcStats.markUsec = uint32_t(get_time_usec(t0));
         // sweep
+        auto t1 = ref_time_ticks();
         if ( sheap ) stringHeap->sweep();
-        // report errors
         heap->sweep();
+        gcStats.sweepUsec = uint32_t(get_time_usec(t1));
+        gcStats.markThreads = markThreads;
+        gcStats.markTasks = markTasks;
+        gcStats.collections ++;
+        // report errors
         if ( !walker.failed.empty() ) {
             reportAnyHeap(at, sheap, true, true, true);
             TextWriter tw;
@@ -1064,6 +1239,14 @@ namespace das
         }
     }
 
+    void Context::collectRetired ( LineInfo * at ) {
+        for ( auto & rs : retiredStorage ) {
+            free(rs.first, rs.second, at);
+        }
+        retiredStorage.clear();
+        retiredBytes = 0;
+    }
+
     // this one frees data from under arrays and tables only
     struct  GcPod : public DataWalker {
         enum {
@@ -1105,6 +1288,7 @@ namespace das
         virtual void afterTable ( Table * pa, TypeInfo * ti ) override {
             if ( pa->data ) {
                 if ( !pa->isLocked() || pa->hopeless ) {
+                    if ( pa->resizeData ) table_finish_resize(__context__, *pa, __at__);
                     uint32_t oldSize = pa->capacity*(ti->firstType->size+ti->secondType->size+sizeof(TableHashKey));
                     __context__->free(pa->data, oldSize, __at__);
                 } else {
@@ -9,6 +9,7 @@
 #include "daScript/ast/ast_aot_cpp.h"
 #include "daScript/misc/crash_handler.h"
 #include "daScript/misc/job_que.h"
+#include <thread>
 #if defined(_WIN32) && defined(_DEBUG)
 #include <crtdbg.h>
 #endif
@@ -30,6 +31,9 @@ static string aotResult = "";
 // aot config end
 static bool paranoid_validation = false;
 static bool profilerRequired = false;
+static bool pgoRecordRequired = false;
+static string samplingProfilerFile;
+static uint32_t samplingProfilerInterval = 1000;
 static bool debuggerRequired = false;
 static bool scopedStackAllocator = true;
 static bool pauseAfterErrors = false;
@@ -55,6 +59,8 @@ static bool version2syntax = true;
 static bool gen2MakeSyntax = false;
 static bool trackAllocations = false;
 static bool heapReportAtExit = false;
+static int compileJobs = 1;
+static string programCacheFolder;
 
 static CodeOfPolicies getPolicies() {
     CodeOfPolicies policies;
@@ -232,7 +238,7 @@ int das_aot_main ( int argc, char * argv[] ) {
 // returns process exit code:
 //   0 on success
 //   non-zero from int main, or 1 on compile/simulate/verify/exception failure
-int compile_and_run ( const string & fn, const string & mainFnName, bool outputProgramCode, bool dryRun, bool compileOnly, const char * introFile = nullptr ) {
+int compile_and_run ( const string & fn, const string & mainFnName, bool outputProgramCode, bool dryRun, bool compileOnly, TextWriter & out, const char * introFile = nullptr ) {
     // Heap-leak tracker: arm the tail-memoize landmark so per-allocation stack
     // captures below this frame skip re-walking ancestors. No-op when
     // DAS_TRACK_ALLOC is off or on non-Win64.
@@ -251,6 +257,9 @@ int compile_and_run ( const string & fn, const string & mainFnName, bool outputP
     } else if ( profilerRequired ) {
         policies.profiler = true;
         access->addExtraModule("profiler", getDasRoot() + "/daslib/profiler.das");
+    } else if ( pgoRecordRequired ) {
+        policies.profiler = true;
+        access->addExtraModule("pgo", getDasRoot() + "/daslib/pgo.das");
     } /*else*/ if ( jitEnabled != JitMode::None ) {
         policies.jit_enabled = true;
         switch (jitEnabled) {
@@ -277,26 +286,34 @@ int compile_and_run ( const string & fn, const string & mainFnName, bool outputP
     policies.track_allocations = trackAllocations;
     policies.no_lint = noLint;
     policies.persistent_heap = true;
-    if ( auto program = compileDaScript(fn,access,tout,dummyGroup,policies) ) {
+    ProgramPtr compiled;
+    if ( !programCacheFolder.empty() && !debuggerRequired ) {
+        // one cache file per script, named after the hash of its path
+        auto cacheFile = programCacheFolder + "/" + to_string(hash_blockz64((const uint8_t *)fn.c_str())) + ".das_cache";
+        compiled = compileDaScriptCached(fn,cacheFile,access,out,dummyGroup,policies);
+    } else {
+        compiled = compileDaScript(fn,access,out,dummyGroup,policies);
+    }
+    if ( auto program = compiled ) {
         if ( program->failed() ) {
             for ( auto & err : program->errors ) {
-                tout << reportError(err.at, err.what, err.extra, err.fixme, err.cerr );
+                out << reportError(err.at, err.what, err.extra, err.fixme, err.cerr );
             }
             if ( pauseAfterErrors ) {
                 getchar();
             }
         } else {
             if ( outputProgramCode )
-                tout << *program << "\n";
+                out << *program << "\n";
             if ( compileOnly )
                 return 0;
 
-            auto pctx = SimulateWithErrReport(program, tout);
+            auto pctx = SimulateWithErrReport(program, out);
             // Check for compiler leaks (TypeDecl nodes left on thread root after compile+simulate)
             {
                 auto & root = gc_root::gc_get_thread_root();
                 if (root.gc_count != 0) {
-                    tout << "GC COMPILE LEAK: " << uint64_t(root.gc_count) << " gc_node(s) after compile\n";
+                    out << "GC COMPILE LEAK: " << uint64_t(root.gc_count) << " gc_node(s) after compile\n";
                     root.gc_report();
                 }
             }
@@ -304,9 +321,9 @@ int compile_and_run ( const string & fn, const string & mainFnName, bool outputP
                 exitCode = 1;
             } else if ( dryRun ) {
                 exitCode = 0;
-                tout << "dry run: " << fn << "\n";
+                out << "dry run: " << fn << "\n";
             } else if ( program->thisModule->isModule ) {
-                tout<< "WARNING: program is setup as both module, and endpoint.\n";
+                out<< "WARNING: program is setup as both module, and endpoint.\n";
             } else {
                 auto fnVec = pctx->findFunctions(mainFnName.c_str());
                 das::vector<SimFunction *> fnMVec;
@@ -318,24 +335,40 @@ int compile_and_run ( const string & fn, const string & mainFnName, bool outputP
                     }
                 }
                 if ( fnMVec.size()==0 ) {
-                    tout << "function '"  << mainFnName << "' not found\n";
+                    out << "function '"  << mainFnName << "' not found\n";
                 } else if ( fnMVec.size()>1 ) {
-                    tout << "too many options for '" << mainFnName << "'\ncandidates are:\n";
+                    out << "too many options for '" << mainFnName << "'\ncandidates are:\n";
                     for ( auto fnAS : fnMVec ) {
-                        tout << "\t" << fnAS->mangledName << "\n";
+                        out << "\t" << fnAS->mangledName << "\n";
                     }
                 } else {
                     exitCode = 0;
                     auto fnTest = fnMVec.back();
                     pctx->restart();
+                    if ( !samplingProfilerFile.empty() ) {
+                        pctx->startSampling(samplingProfilerInterval);
+                    }
                     vec4f res;
                     if ( debuggerRequired ) {
                         res = pctx->eval(fnTest, nullptr);
                     } else {
                         res = pctx->evalWithCatch(fnTest, nullptr);
                     }
+                    if ( !samplingProfilerFile.empty() ) {
+                        pctx->stopSampling();
+                        TextWriter folded;
+                        auto samples = pctx->reportSamples(folded);
+                        auto text = folded.str();
+                        if ( FILE * sf = fopen(samplingProfilerFile.c_str(), "wb") ) {
+                            fwrite(text.c_str(), 1, text.length(), sf);
+                            fclose(sf);
+                            out << "sampling profiler: " << samples << " samples written to " << samplingProfilerFile << "\n";
+                        } else {
+                            out << "sampling profiler: can't write " << samplingProfilerFile << "\n";
+                        }
+                    }
                     if ( auto ex = pctx->getException() ) {
-                        tout << "EXCEPTION: " << ex << " at " << pctx->exceptionAt.describe() << "\n";
+                        out << "EXCEPTION: " << ex << " at " << pctx->exceptionAt.describe() << "\n";
                         exitCode = 1;
                     } else if ( fnTest->debugInfo && fnTest->debugInfo->result ) {
                         auto resType = fnTest->debugInfo->result->type;
@@ -349,16 +382,16 @@ int compile_and_run ( const string & fn, const string & mainFnName, bool outputP
                     {
                         auto & root = gc_root::gc_get_thread_root();
                         if (root.gc_count != 0) {
-                            tout << "GC APP LEAK: " << uint64_t(root.gc_count) << " gc_node(s) after execution\n";
+                            out << "GC APP LEAK: " << uint64_t(root.gc_count) << " gc_node(s) after execution\n";
                             root.gc_report();
                         }
                     }
                 }
             }
             if ( heapReportAtExit && pctx ) {
-                tout << "--- heap report ---\n";
+                out << "--- heap report ---\n";
                 pctx->heap->report();
-                tout << "--- string heap report ---\n";
+                out << "--- string heap report ---\n";
                 pctx->stringHeap->report();
             }
         }
@@ -397,6 +430,61 @@ static string deduce_project_root(string maybe_project_root, string compile_file
     return "";
 }
 
+// every thread which compiles has its own environment, with its own instance of every module
+static void register_modules ( string & project_root, const string & firstFile, TextWriter & logs ) {
+    register_builtin_modules();
+    require_project_specific_modules();
+    #if !defined(DAS_ENABLE_DLL) || !defined(DAS_ENABLE_DYN_INCLUDES)
+    // Otherwises search for static modules.
+    #include "modules/external_need.inc"
+    #endif
+    #ifdef DAS_ENABLE_DYN_INCLUDES
+    if ( !noDynamicModules ) {
+        // Search for external modules and init them. Only if flag is enabled.
+        daScriptEnvironment::ensure();
+        project_root = deduce_project_root(project_root, firstFile);
+        auto access = get_file_access((char*)(projectFile.empty() ? nullptr : projectFile.c_str()));
+        require_dynamic_modules(access, getDasRoot(), project_root, logs);
+    }
+    #else
+    (void)project_root; (void)firstFile; (void)logs;
+    #endif
+    Module::Initialize();
+}
+
+// compiles files on compileJobs threads. files are picked up one by one, output is printed in the order of files
+static int compile_files_parallel ( const das::vector<string> & files, const string & mainName, bool outputProgramCode,
+        bool dryRun, bool compileOnly, string project_root ) {
+    das::vector<string> logs(files.size());
+    das::vector<int> codes(files.size(), 0);
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        for ( size_t i = next++; i < files.size(); i = next++ ) {
+            TextWriter out;
+            codes[i] = compile_and_run(files[i], mainName, outputProgramCode, dryRun, compileOnly, out);
+            logs[i] = out.str();
+        }
+    };
+    size_t totalThreads = min(size_t(compileJobs), files.size());
+    das::vector<std::thread> threads;
+    for ( size_t t = 1; t < totalThreads; ++t ) {
+        threads.emplace_back([&]() {
+            TextWriter moduleLogs;
+            register_modules(project_root, files.front(), moduleLogs);
+            work();
+            Module::Shutdown(false);
+        });
+    }
+    work();
+    for ( auto & th : threads ) th.join();
+    int exitCode = 0;
+    for ( size_t i = 0; i != files.size(); ++i ) {
+        tout << logs[i];
+        if ( codes[i] != 0 ) exitCode = codes[i];
+    }
+    return exitCode;
+}
+
 void replace( string& str, const string& from, const string& to ) {
     size_t it = str.find(from);
     if( it != string::npos ) {
@@ -425,11 +513,14 @@ void print_help() {
         << "    -pause      pause after errors and pause again before exiting program\n"
         << "    -dry-run    compile and simulate script without execution\n"
         << "    -compile-only compile script without simulation and execution\n"
+        << "    -jobs <N>   with -compile-only or -dry-run, compile files on N threads (0 - one per core)\n"
+        << "    -program-cache <folder> reuse compiled programs from the folder, when sources and options did not change\n"
         << "    -dasroot <path> set path to daslang root folder (with daslib)\n"
         << "    --track-smart-ptr <id> track smart pointer with id\n"
         << "    --track-job-status <id> track JobStatus/Channel/LockBox with id\n"
         << "    --no-dump-leaks  silence the JobStatus + HandleRegistry + smart_ptr leak dumps at exit (default: dump)\n"
         << "    --linear-stack-allocator  disable scoped stack allocator\n"
+        << "    --jobque-work-stealing  job que workers use per thread deques and steal jobs from each other\n"
         << "    --das-wait-debugger wait for debugger to attach\n"
         << "    --das-profiler enable profiler\n"
         << "    --das-profiler-log-file <file> set profiler log file\n"
@@ -439,6 +530,9 @@ void print_help() {
         << "    --das-profiler-thread-local install profiler as per-thread agent (default when not tracking memory)\n"
         << "    --das-profiler-global install profiler as singleton agent (default with --das-profiler-memory)\n"
         << "    --das-profiler-leaks track live heap allocations and dump leaks on context destroy\n"
+        << "    --das-sampling-profiler <file> sample call stacks of the main context, write folded stacks to file\n"
+        << "    --das-sampling-interval <usec> sampling profiler interval (default 1000)\n"
+        << "    --das-pgo-record <file> count statements, write profile for 'options pgo_profile' to file\n"
         << "    -no-dynamic-modules  skip loading dynamic modules from dasroot and project root\n"
         << "    -no-lint    skip the lint pass (Program::lint)\n"
         << "    --          separator for script arguments\n"
@@ -538,6 +632,22 @@ int MAIN_FUNC_NAME ( int argc, char * argv[] ) {
                 trackAllocations = true;
             } else if ( cmd=="heap-report" ) {
                 heapReportAtExit = true;
+            } else if ( cmd=="jobs" ) {
+                if ( i+1 >= argc || sscanf(argv[i+1], "%d", &compileJobs)!=1 || compileJobs<0 ) {
+                    printf("jobs requires number of threads\n");
+                    print_help();
+                    return -1;
+                }
+                if ( compileJobs==0 ) compileJobs = int(max(std::thread::hardware_concurrency(), 1u));
+                i += 1;
+            } else if ( cmd=="program-cache" ) {
+                if ( i+1 >= argc ) {
+                    printf("program-cache requires argument\n");
+                    print_help();
+                    return -1;
+                }
+                programCacheFolder = argv[i+1];
+                i += 1;
             } else if ( cmd=="jit") {
                 jitEnabled = JitMode::Direct;
             } else if ( cmd=="use-aot") {
@@ -659,6 +769,8 @@ int MAIN_FUNC_NAME ( int argc, char * argv[] ) {
                 debuggerRequired = true;
             } else if ( cmd=="-linear-stack-allocator") {
                 scopedStackAllocator = false;
+            } else if ( cmd=="-jobque-work-stealing") {
+                g_jobque_backend = int32_t(JobQueBackend::WorkStealing);
             } else if ( cmd=="-das-profiler") {
                 profilerRequired = true;
             } else if ( cmd=="-das-profiler-log-file") {
@@ -679,6 +791,30 @@ int MAIN_FUNC_NAME ( int argc, char * argv[] ) {
                 // do nothing, script handles it
             } else if ( cmd=="-das-profiler-leaks" ) {
                 // do nothing, script handles it
+            } else if ( cmd=="-das-pgo-record" ) {
+                // script will pick up next argument by itself
+                if ( i+1 >= argc ) {
+                    printf("expecting PGO profile file name\n");
+                    print_help();
+                    return -1;
+                }
+                pgoRecordRequired = true;
+                i += 1;
+            } else if ( cmd=="-das-sampling-profiler" ) {
+                if ( i+1 >= argc ) {
+                    printf("expecting sampling profiler output file name\n");
+                    print_help();
+                    return -1;
+                }
+                samplingProfilerFile = argv[i+1];
+                i += 1;
+            } else if ( cmd=="-das-sampling-interval" ) {
+                if ( i+1 >= argc || sscanf(argv[i+1], "%u", &samplingProfilerInterval)!=1 ) {
+                    printf("expecting sampling profiler interval in microseconds\n");
+                    print_help();
+                    return -1;
+                }
+                i += 1;
             } else if ( cmd=="-das-profiler-time-unit" ) {
                 // script will pick up next argument by itself
                 if ( i+1 >= argc ) {
@@ -711,22 +847,7 @@ int MAIN_FUNC_NAME ( int argc, char * argv[] ) {
         return -1;
     }
     // register modules
-    register_builtin_modules();
-    require_project_specific_modules();
-    #if !defined(DAS_ENABLE_DLL) || !defined(DAS_ENABLE_DYN_INCLUDES)
-    // Otherwises search for static modules.
-    #include "modules/external_need.inc"
-    #endif
-    #ifdef DAS_ENABLE_DYN_INCLUDES
-    if ( !noDynamicModules ) {
-        // Search for external modules and init them. Only if flag is enabled.
-        daScriptEnvironment::ensure();
-        project_root = deduce_project_root(project_root, files.front());
-        auto access = get_file_access((char*)(projectFile.empty() ? nullptr : projectFile.c_str()));
-        require_dynamic_modules(access, getDasRoot(), project_root, tout);
-    }
-    #endif
-    Module::Initialize();
+    register_modules(project_root, files.front(), tout);
 
     if (formatter) {
         return format::run(formatter.value(), files);
@@ -740,9 +861,18 @@ int MAIN_FUNC_NAME ( int argc, char * argv[] ) {
 
     for ( auto & fn : files ) {
         replace(fn, "_dasroot_", getDasRoot());
-        int rc = compile_and_run(fn, mainName, outputProgramCode, dryRun, compileOnly);
-        if ( rc != 0 ) {
-            exitCode = rc;
+    }
+    // nothing runs, and nothing waits for input, so files can be compiled independently
+    bool parallel = compileJobs>1 && files.size()>1 && (compileOnly || dryRun) && jitEnabled==JitMode::None
+        && !debuggerRequired && !profilerRequired && !pauseAfterErrors && !heapReportAtExit;
+    if ( parallel ) {
+        exitCode = compile_files_parallel(files, mainName, outputProgramCode, dryRun, compileOnly, project_root);
+    } else {
+        for ( auto & fn : files ) {
+            int rc = compile_and_run(fn, mainName, outputProgramCode, dryRun, compileOnly, tout);
+            if ( rc != 0 ) {
+                exitCode = rc;
+            }
         }
     }
     // and done
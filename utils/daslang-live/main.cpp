@@ -38,6 +38,7 @@ static string project_root;
 static bool version2syntax = true;
 static bool trackAllocations = false;
 static bool heapReportAtExit = false;
+static bool hotPatch = false;
 
 // --- DLL function pointers (loaded at runtime from dasModuleLiveHost) ---
 // All use POD types only — safe across DLL boundary.
@@ -297,6 +298,7 @@ static void set_watched_files(Context * ctx) {
 
 static int run_lifecycle(const string & fn) {
     auto cr = compile_script(fn);
+    vector<CompileResult> patches;  // programs, which code was hot patched into the context
 
     Context * ctx = cr.ctx ? cr.ctx.get() : nullptr;
     SimFunction * fnInit = nullptr;
@@ -429,6 +431,34 @@ static int run_lifecycle(const string & fn) {
         if (needsReload) {
             tout << "daslang-live: reloading...\n";
 
+            // Hot patch: compile first, and if only function bodies changed, patch them into the running
+            // context. Globals, heap, and everything init() did stay, no shutdown/init is called
+            CompileResult newCr;
+            bool compiled = false;
+            if (hotPatch && ctx && !ctx_had_exception && !(dll_full_reload && dll_full_reload())) {
+                newCr = compile_script(fn);
+                compiled = true;
+                if (!newCr.ctx) {
+                    tout << "daslang-live: reload FAILED, keeping old context (paused)\n";
+                    if (dll_set_last_error) dll_set_last_error(newCr.errors.c_str());
+                    if (dll_set_paused) dll_set_paused(true);
+                    if (dll_clear_reload_flags) dll_clear_reload_flags();
+                    continue;
+                }
+                TextWriter patchLog;
+                auto patched = ctx->hotPatchFrom(newCr.ctx, &patchLog);
+                tout << patchLog.str();
+                if (patched >= 0) {
+                    set_watched_files(newCr.ctx.get());
+                    patches.emplace_back(das::move(newCr));
+                    if (dll_set_paused) dll_set_paused(false);
+                    if (dll_clear_reload_flags) dll_clear_reload_flags();
+                    if (dll_clear_error) dll_clear_error();
+                    tout << "daslang-live: hot patch complete, " << patched << " function(s) patched\n";
+                    continue;
+                }
+            }
+
             // Set reload flag BEFORE shutdown so is_reload() returns true
             if (dll_set_is_reload) dll_set_is_reload(true);
 
@@ -450,7 +480,9 @@ static int run_lifecycle(const string & fn) {
             }
 
             // Recompile
-            auto newCr = compile_script(fn);
+            if (!compiled) {
+                newCr = compile_script(fn);
+            }
             if (!newCr.ctx) {
                 tout << "daslang-live: reload FAILED, keeping old context (paused)\n";
                 if (dll_set_last_error) dll_set_last_error(newCr.errors.c_str());
@@ -471,6 +503,7 @@ static int run_lifecycle(const string & fn) {
             // Swap to new context
             cr = das::move(newCr);
             ctx = cr.ctx.get();
+            patches.clear();
 
             // Re-find functions
             fnInit = find_void_function(ctx, "init");
@@ -573,6 +606,7 @@ static void print_help() {
     tout << "  -v1syntax          - use v1 syntax (default: v2)\n";
     tout << "  -track-allocations - track where heap allocations came from\n";
     tout << "  -heap-report       - dump heap contents on shutdown\n";
+    tout << "  -hot-patch         - patch changed functions into the running context, when globals and types did not change\n";
     tout << "  --no-dyn-modules   - skip loading dynamic modules\n";
     tout << "  --no-dump-leaks    - silence JobStatus + HandleRegistry leak dumps at exit (default: dump)\n";
     tout << "  --                 - separator for script arguments\n";
@@ -659,6 +693,8 @@ int main(int argc, char * argv[]) {
             trackAllocations = true;
         } else if (arg == "-heap-report") {
             heapReportAtExit = true;
+        } else if (arg == "-hot-patch") {
+            hotPatch = true;
         } else if (arg == "--no-dyn-modules") {
             noDynamicModules = true;
         } else if (arg == "--dump-leaks") {